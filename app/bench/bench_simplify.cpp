@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2015,2023 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+//      bench_simplify.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+//
+//      Microbenchmark of Braket::simplify() on Bop() x psi_16p products.
+//      Usage: bench_simplify [repetitions]
+
+#include <son.h>
+#include <tools/so10.h>
+
+using namespace std;
+using namespace sospin;
+
+/*! \brief Times "reps" calls of simplify() on copies of "exp" */
+static void bench(const string& name, Braket exp, int reps) {
+  double total = 0;
+  size_t terms = 0;
+  for (int i = 0; i < reps; i++) {
+    Braket tmp = exp;
+    Timer t;
+    t.start();
+    tmp.simplify();
+    t.stop();
+    total += t.getElapsedTimeInMicroSec();
+    terms = tmp.size();
+  }
+  cout << name << ": " << exp.size() << " -> " << terms << " terms\t" << total / reps << " us/simplify" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  int reps = 200;
+  if (argc > 1) reps = atoi(argv[1]);
+  setDim(10);
+  setVerbosity(SILENT);
+  bench("Bop(\"j\") * psi_16p(ket)", Bop("j") * psi_16p(ket, "k"), reps);
+  bench("BopIdnum() * psi_16p(ket)", BopIdnum() * psi_16p(ket, "k"), reps);
+  bench("psi_16p(bra) * Bop(\"j\") * GammaH(1) * psi_16p(ket)", psi_16p(bra, "i") * Bop("j") * GammaH(1) * psi_16p(ket, "k"), reps);
+  CleanGlobalDecl();
+  return 0;
+}
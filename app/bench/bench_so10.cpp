@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2015,2023 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//      bench_so10.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+//
+//      Microbenchmark of the SO(10) constructors (GammaH, psi_*), cold (built) and warm (from the templates).
+//      Usage: bench_so10 [repetitions]
+
+#include <son.h>
+#include <tools/so10.h>
+
+using namespace std;
+using namespace sospin;
+
+/*! \brief Times "reps" cold and warm calls of "build" */
+template <class F>
+static void bench(const string& name, F build, int reps) {
+  double cold = 0, warm = 0;
+  for (int i = 0; i < reps; i++) {
+    clearSO10Templates();
+    Timer t;
+    t.start();
+    build();
+    t.stop();
+    cold += t.getElapsedTimeInMicroSec();
+    t.start();
+    build();
+    t.stop();
+    warm += t.getElapsedTimeInMicroSec();
+  }
+  cout << name << ": cold " << cold / reps << " us\twarm " << warm / reps << " us" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  int reps = 200;
+  if (argc > 1) reps = atoi(argv[1]);
+  setDim(10);
+  setVerbosity(SILENT);
+  for (int n = 0; n <= 5; n++) bench("GammaH(" + ToString<int>(n) + ")", [n]() { GammaH(n); }, reps);
+  bench("psi_16p(ket)", []() { psi_16p(ket); }, reps);
+  bench("psi_16p(ket, \"k\")", []() { psi_16p(ket, "k"); }, reps);
+  bench("psi_16m(bra)", []() { psi_16m(bra); }, reps);
+  bench("psi_144p(ket)", []() { psi_144p(ket); }, reps);
+  bench("psi_144m(bra)", []() { psi_144m(bra); }, reps);
+  CleanGlobalDecl();
+  return 0;
+}
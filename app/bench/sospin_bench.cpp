@@ -0,0 +1,196 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2015,2023 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//      sospin_bench.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+//
+//      Microbenchmarks of DList, Braket and the FORM input/output, printed as JSON.
+//      Usage: sospin_bench [repetitions] [output.json]
+
+#include <son.h>
+#include <tools/so10.h>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+using namespace sospin;
+
+/*! \brief Timings of one benchmark */
+struct BenchResult {
+  string name;
+  int reps;
+  double mean;
+  double min;
+  size_t items;
+};
+
+static vector<BenchResult> results;
+
+/*! \brief Times "reps" batches of "batch" calls of "run", which returns the number of items it produced (terms, bytes, ...).
+    The times reported are per call.
+*/
+template <class F>
+static void bench(const string& name, int reps, int batch, F run) {
+  BenchResult r;
+  r.name = name;
+  r.reps = reps;
+  r.mean = 0;
+  r.min = 0;
+  r.items = 0;
+  for (int i = 0; i < reps; i++) {
+    Timer t;
+    t.start();
+    for (int j = 0; j < batch; j++) r.items = run();
+    t.stop();
+    double us = t.getElapsedTimeInMicroSec() / batch;
+    r.mean += us;
+    r.min = i == 0 ? us : min(r.min, us);
+  }
+  r.mean /= reps;
+  results.push_back(r);
+  cerr << name << ": " << r.mean << " us (min " << r.min << " us), " << r.items << " items" << endl;
+}
+
+static string JsonString(const string& s) {
+  string out = "\"";
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] == '"' || s[i] == '\\') out += '\\';
+    out += s[i];
+  }
+  return out + "\"";
+}
+
+static void WriteJson(ostream& out, int reps) {
+  out << "{\n  \"version\": 1,\n  \"repetitions\": " << reps << ",\n  \"threads\": " << getThreads() << ",\n";
+  out << "  \"peak_rss_bytes\": " << getPeakRSS() << ",\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchResult& r = results[i];
+    out << "    {\"name\": " << JsonString(r.name) << ", \"reps\": " << r.reps << ", \"mean_us\": " << r.mean
+        << ", \"min_us\": " << r.min << ", \"items\": " << r.items << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}" << endl;
+}
+
+/*! \brief Returns a monomial of n elements b(i?) bt(j?) d_(k?,l?) cycling over the element types */
+static DList Monomial(int n) {
+  DList d;
+  for (int i = 0; i < n; i++) {
+    string id = ToString<int>(i % 5 + 1);
+    if (i % 3 == 0) d << elemType::make_elem(0, newIdx("i" + id));
+    if (i % 3 == 1) d << elemType::make_elem(1, newIdx("j" + id));
+    if (i % 3 == 2) d << elemType::make_elem(2, newIdx("k" + id), newIdx("l" + id));
+  }
+  return d;
+}
+
+/*! \brief FORM output with "terms" terms, as read by ParseFormOutput */
+static string FormOutputText(int terms) {
+  string out = "FORM 4.3\n\n   R =\n";
+  for (int i = 0; i < terms; i++)
+    out += "       + " + ToString<int>(i + 1) + "*d_(N1_?,N2_?)*e_(i1,i2,i3,N3_?,N4_?)*H(N" + ToString<int>(i % 9 + 1) + "_?)\n";
+  return out + "      ;\n\n  0.01 sec out of 0.01 sec\n";
+}
+
+int main(int argc, char *argv[]) {
+  int reps = 20;
+  if (argc > 1) reps = atoi(argv[1]);
+  setVerbosity(SILENT);
+
+  setDim(10);
+  DList d8 = Monomial(8), d24 = Monomial(24);
+  bench("DList copy (8)", reps, 1000, [&]() { DList c = d8; return (size_t)c.size(); });
+  bench("DList copy (24)", reps, 1000, [&]() { DList c = d24; return (size_t)c.size(); });
+  bench("DList concat (8 x 8)", reps, 1000, [&]() { return (size_t)(d8 * d8).size(); });
+  bench("DList concat (24 x 24)", reps, 1000, [&]() { return (size_t)(d24 * d24).size(); });
+  // b(i1) bt(j1) ... b(i5) bt(j5) for contract_deltas, bt(j1) b(i1) ... for ordering
+  DList bbt, btb;
+  for (int i = 1; i <= 5; i++) {
+    elemType b = elemType::make_elem(0, newIdx("i" + ToString<int>(i)));
+    elemType bt = elemType::make_elem(1, newIdx("j" + ToString<int>(i)));
+    bbt << b << bt;
+    btb << bt << b;
+  }
+  bench("contract_deltas (5 b, 5 bt)", reps, 1000, [&]() {
+    DList c = bbt;
+    return (size_t)contract_deltas(c, false).size();
+  });
+  bench("ordering (5 b, 5 bt)", reps, 1000, [&]() {
+    DList c = btb;
+    return (size_t)ordering(c, false).size();
+  });
+  CleanGlobalDecl();
+
+  for (int n = 2; n <= 7; n++) {
+    setDim(2 * n);
+    bench("Bop() SO(" + ToString<int>(2 * n) + ")", reps, 1, []() { return (size_t)Bop().size(); });
+    CleanGlobalDecl();
+  }
+
+  setDim(10);
+  Braket left = psi_16p(bra, "i") * Bop("j"), right = GammaH(3) * psi_16p(ket, "k");
+  bench("Braket::operator* (psi_16p Bop x GammaH psi_16p)", reps, 1, [&]() { return (size_t)(left * right).size(); });
+  Braket product = Bop("j") * psi_16p(ket, "k");
+  bench("Braket::simplify (Bop psi_16p)", reps, 1, [&]() {
+    Braket tmp = product;
+    tmp.simplify();
+    return (size_t)tmp.size();
+  });
+  Braket full = left * right;
+  bench("Braket::evaluate(true)", reps, 1, [&]() {
+    Braket tmp = full;
+    tmp.evaluate(true);
+    return (size_t)tmp.size();
+  });
+  bench("Braket::evaluate(false)", reps, 1, [&]() {
+    Braket tmp = full;
+    tmp.evaluate(false);
+    return (size_t)tmp.size();
+  });
+  Braket evaluated = full;
+  evaluated.evaluate(true);
+  bench("FORM input (writeForm)", reps, 1, [&]() {
+    ostringstream out;
+    evaluated.writeForm(out);
+    return (size_t)out.str().size();
+  });
+  string text = FormOutputText(10000);
+  bench("FORM output (ParseFormOutput, 10000 terms)", reps, 1, [&]() {
+    return ParseFormOutput(text.data(), text.data() + text.size(), "j").terms.size();
+  });
+  CleanGlobalDecl();
+
+  if (argc > 2) {
+    ofstream out(argv[2]);
+    WriteJson(out, reps);
+  } else
+    WriteJson(cout, reps);
+  return 0;
+}
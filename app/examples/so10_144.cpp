@@ -50,6 +50,8 @@ int main(int argc, char *argv[]) {
   cout << "Verbosity type: " << getVerbosity() << endl;
   // unsetSimplifyIndexSum();
   Braket exp, exp0, exp1, exp2;
+  Timer evaltime;
+  evaltime.start();
   exp0 = psi_144m(bra) * Bop("j");
   exp1 = GammaH(0) * psi_144p(ket);
   cout << "################################################################" << endl;
@@ -58,6 +60,7 @@ int main(int argc, char *argv[]) {
     exp.evaluate(false);  // levi-civita
   else
     exp.evaluate(true);  // only deltas
+  cout << "Time evaluate: " << evaltime.getElapsedTimeInMicroSec() << " us\t" << evaltime.getElapsedTimeInSec() << " s" << endl;
   // unsetFormIndexSum();
   CallForm(exp, false, true, "i");
   setFormRenumber();
@@ -0,0 +1,208 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+//       arena.h created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Memory arena used to allocate the short-lived DList storage created during a Braket evaluation.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace sospin {
+
+/*! \def EVAL_ARENA_CHUNK_SIZE
+  \brief Default size in bytes of each block of memory reserved by an EvalArena
+*/
+#ifndef EVAL_ARENA_CHUNK_SIZE
+#define EVAL_ARENA_CHUNK_SIZE (1 << 20)
+#endif
+
+/*!
+  \class EvalArena
+  \brief RAII scope for a memory arena
+
+  While an EvalArena object is alive, every DList heap buffer and every node of the DList
+  lists used by the evaluation routines (EvaluateToDeltas, ReduceNumberOfBandBdaggers,
+  OrderBandBdaggers) is taken from large chunks owned by the arena instead of the global heap.
+  Freed blocks are recycled through per-size free lists and the chunks are released in bulk
+  when the scope ends.
+
+  Memory still referenced when the scope ends (for example, the terms of an evaluated Braket)
+  remains valid: the chunk holding it is released when its last block is freed.
+  Scopes can be nested, the innermost one is used. The arena belongs to the thread that created it:
+  the worker threads of Braket::evaluate open their own arenas, added to this one with merge() when they finish.
+
+\code
+{
+  EvalArena arena;
+  exp.evaluate();
+  arena.report();
+}
+\endcode
+*/
+class EvalArena {
+ public:
+  /*! \brief Opens a new arena scope
+      \param[in] chunkbytes size of each chunk of memory requested from the system
+  */
+  explicit EvalArena(size_t chunkbytes = EVAL_ARENA_CHUNK_SIZE);
+  /*! \brief Closes the scope and releases all chunks not in use */
+  ~EvalArena();
+
+  /*! \brief Returns the innermost arena of the calling thread, or 0 if none is open */
+  static EvalArena* current();
+
+  /*! \brief Allocates "bytes" from the current arena, or from the heap if no arena is open */
+  static void* allocate(size_t bytes);
+  /*! \brief Frees a block returned by allocate(), wherever it came from */
+  static void deallocate(void* ptr);
+
+  /*! \brief Total bytes reserved from the system */
+  size_t bytesReserved() const { return reserved; }
+  /*! \brief Bytes currently handed out */
+  size_t bytesInUse() const { return inuse; }
+  /*! \brief Maximum of bytesInUse() during the scope */
+  size_t peakBytesInUse() const { return peak; }
+  /*! \brief Number of allocations served by the arena */
+  size_t nodes() const { return numnodes; }
+  /*! \brief Number of allocations served from the free lists */
+  size_t nodesRecycled() const { return numrecycled; }
+
+  /*! \brief Size of each chunk of memory requested from the system */
+  size_t chunkBytes() const { return chunksize; }
+  /*! \brief Adds the statistics of "other", the arena of another thread, to this arena */
+  void merge(const EvalArena& other);
+
+  /*! \brief Prints the arena statistics */
+  void report(ostream& out = cout) const;
+
+ private:
+  struct Chunk;
+  struct BlockHeader;
+
+  /*! \brief Allocates a block of "size" bytes (header included) */
+  void* take(size_t size);
+
+  /*! \brief Size classes are multiples of 16 bytes up to this limit, bigger blocks go to the heap */
+  static const size_t kMaxBlock = 1024;
+  static const size_t kAlign = 16;
+
+  /*! \brief Enclosing arena, restored when this scope ends */
+  EvalArena* previous;
+  /*! \brief Chunks owned by the arena */
+  vector<Chunk*> chunks;
+  /*! \brief Free lists, one per size class */
+  void* freelist[kMaxBlock / kAlign + 1];
+  /*! \brief Bump pointer in the last chunk */
+  char* cursor;
+  /*! \brief Bytes left in the last chunk */
+  size_t left;
+  /*! \brief Size of each chunk */
+  size_t chunksize;
+
+  size_t reserved;
+  size_t inuse;
+  size_t peak;
+  size_t numnodes;
+  size_t numrecycled;
+
+  EvalArena(const EvalArena&);
+  EvalArena& operator=(const EvalArena&);
+};
+
+/*!
+  \class ArenaAllocator
+  \brief Standard allocator that takes memory from the current EvalArena (or the heap if none is open)
+*/
+template <class T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <class U>
+  struct rebind {
+    typedef ArenaAllocator<U> other;
+  };
+
+  ArenaAllocator() {}
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(EvalArena::allocate(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t) {
+    EvalArena::deallocate(p);
+  }
+  size_t max_size() const {
+    return numeric_limits<size_t>::max() / sizeof(T);
+  }
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args) {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+  template <class U>
+  void destroy(U* p) {
+    p->~U();
+  }
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>&, const ArenaAllocator<U>&) {
+  return false;
+}
+
+}  // namespace sospin
+
+#endif
@@ -42,6 +42,7 @@
 #ifndef BRAKET_H
 #define BRAKET_H
 
+#include <sospin/coefficient.h>
 #include <sospin/dlist.h>
 #include <sospin/enum.h>
 
@@ -50,6 +51,7 @@
 #include <cstring>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -64,6 +66,54 @@ void setSimplifyIndexSum();
 /*! \brief Deactivate internal simplifications based on the Braket Index sum */
 void unsetSimplifyIndexSum();
 
+/*! \brief Activate deferred Braket operations: products and sums only record their operands and the expression is
+    expanded and simplified once, when it is needed (evaluate, size, printing, CallForm, ...). This option is deactivated by default.*/
+void setLazyProducts();
+
+/*! \brief Deactivate deferred Braket operations, every product and sum is expanded and simplified immediately */
+void unsetLazyProducts();
+
+/*! \brief Activate Braket::collect() at the end of Braket::evaluate(). This option is deactivated by default.*/
+void setCollectTerms();
+
+/*! \brief Deactivate Braket::collect() at the end of Braket::evaluate() */
+void unsetCollectTerms();
+
+/*! \brief Contract the levi-civita products of Braket::evaluate(false) in the library: e_(a..)*e_(b..) is replaced by
+    the determinant of the deltas d_(a?,b?) instead of being left to FORM, and terms that give a number are written
+    as numbers, summed by CallForm without running FORM. This option is deactivated by default.
+*/
+void setNativeLeviCivita();
+
+/*! \brief Leave the levi-civita products of Braket::evaluate(false) to FORM */
+void unsetNativeLeviCivita();
+
+/*! \brief Returns true after setNativeLeviCivita() */
+bool getNativeLeviCivita();
+
+/*! \brief Braket::evaluate() computes the brakets whose indices are all numbers (BopIdnum(), bb(1), bbt(2), ...)
+    on the Fock space of the N modes (see FockState), writing the matrix element as a number,
+    instead of contracting them into deltas. This option is activated by default.
+*/
+void setFockEvaluation();
+
+/*! \brief Braket::evaluate() contracts every term into deltas or levi-civita, numeric indices included */
+void unsetFockEvaluation();
+
+/*! \brief Evaluate expressions out of core: Braket::evaluate() spills the terms to a file in dir and evaluates them
+    in chunks holding about bytes of terms in memory, the result is kept in a file of dir and read in chunks by
+    writeForm() and CallForm. Any other operation reads the whole result back in memory.
+    The peak resident set size (getPeakRSS()) is reported with setVerbosity(VERBOSE). This option is deactivated by default.
+    \param[in] bytes memory budget of the terms being evaluated, in bytes
+    \param[in] dir directory of the spill files
+*/
+void setEvalMemoryBudget(size_t bytes, string dir = ".");
+
+/*! \brief Evaluate expressions in memory */
+void unsetEvalMemoryBudget();
+
+struct BraketNode;
+
 /*!
   \class BraketOneTerm class
   \brief Store each term of the Braket class
@@ -73,7 +123,7 @@ class BraketOneTerm {
   /*! \brief Store the index sum */
   int index;
   /*! \brief Store the constant part */
-  string constpart;
+  Coefficient constpart;
   /*! \brief Store the part with b and b\daggers and/or delta or identity */
   list<DList> term;
 
@@ -87,8 +137,9 @@ class BraketOneTerm {
   /*! \brief Convert current expression term to levi-civita
       and writes all in the string/constant part only if expression term is a braket
       \param oper expression type, OPMode
+      \return true if the term gives zero (only found after setNativeLeviCivita())
 */
-  void EvaluateEps_2ndPass(OPMode oper);
+  bool EvaluateEps_2ndPass(OPMode oper);
 
  public:
   /*! \brief Constructor */
@@ -115,6 +166,10 @@ class BraketOneTerm {
       \param[in] termin BraketOneTerm expression
   */
   BraketOneTerm(int indexin, string constpartin, BraketOneTerm &termin);
+  BraketOneTerm(const BraketOneTerm &) = default;
+  BraketOneTerm(BraketOneTerm &&) = default;
+  BraketOneTerm &operator=(const BraketOneTerm &) = default;
+  BraketOneTerm &operator=(BraketOneTerm &&) = default;
   /*! \brief Destructor, clear all allocated memory */
   ~BraketOneTerm();
   /*! \brief Clear all allocated memory and sets default parameters */
@@ -122,8 +177,12 @@ class BraketOneTerm {
 
   /*! \brief Return (and set) the term part*/
   list<DList> &GetTerm();
+  /*! \brief Return the constant part as FORM text*/
+  const string GetConst() const;
+  /*! \brief Set the constant part from FORM text*/
+  void SetConst(const string &constpartin);
   /*! \brief Return (and set) the constant part*/
-  string &GetConst();
+  Coefficient &GetCoef();
   /*! \brief Return (and set) the index sum part*/
   int &GetIndex();
 
@@ -153,6 +212,18 @@ class BraketOneTerm {
     \return true if term is empty or gives zero, otherwise returns false
   */
   bool EvaluateToDeltas(OPMode oper);
+  /*! \brief Evaluate the expression term to deltas using Wick's theorem, falls back to EvaluateToDeltas if the term is not a braket
+    \param[in] oper term mode (bra, braket, ket or none)
+    \return true if term is empty or gives zero, otherwise returns false
+  */
+  bool EvaluateWick(OPMode oper);
+  /*! \brief Evaluate the braket term on the Fock space if all its indices are numbers, see setFockEvaluation().
+      The term becomes the number <0| term |0>, times the identity if it is evaluated to deltas.
+    \param[in] onlydeltas true if the term is evaluated to deltas, false if to levi-civita
+    \param[out] zero true if the term gives zero
+    \return false if an index is not a number, the term is then unchanged
+  */
+  bool EvaluateFock(bool onlydeltas, bool &zero);
   /*! \brief Evaluate the expression term to levi-civita
     \param[in] oper term mode (bra, braket, ket or none)
     \return true if term is empty or gives zero, otherwise returns false
@@ -166,11 +237,36 @@ class BraketOneTerm {
   /*! \brief overload operator for BraketOneTerm *= constval */
   BraketOneTerm operator*=(const string constval);
   /*! \brief overload operator for BraketOneTerm * L */
-  BraketOneTerm operator*(const BraketOneTerm &L);
+  BraketOneTerm operator*(const BraketOneTerm &L) const;
   /*! \brief overload operator for BraketOneTerm *= L */
   BraketOneTerm operator*=(const BraketOneTerm &L);
+  /*! \brief Puts every DList in canonical form, sorts them and cancels the DLists that appear with opposite signs
+    \return true if every DList cancelled, ie, the term is zero
+  */
+  bool canonicalize();
+  /*! \brief Returns a 64-bit hash of the canonical term, equal for terms that only differ in constpart or in the overall sign */
+  unsigned long long hash() const;
+  /*! \brief Compares the structure of two canonical terms, ignoring constpart
+    \return 1 if both terms have the same index and DLists, -1 if the DLists have opposite signs, 0 otherwise
+  */
+  int like(const BraketOneTerm &L) const;
+  /*! \brief Appends the MonomialInfo of every DList of the term to out */
+  void summary(vector<MonomialInfo> &out) const;
+  /*! \brief Same as out = (*this) * L, but the products of DLists that simplify() would remove are not built
+    \param[in] L right operand
+    \param[in] info summary() of this term, empty to build every product of DLists
+    \param[in] linfo summary() of L, empty to build every product of DLists
+    \param[in] oper mode of the product (bra, braket, ket or none)
+    \param[in] checkidx if true, the product is dropped when its index sum fails checkindex()
+    \param[out] out product
+    \return false if the whole product is removed by simplify(), in which case out is left unchanged
+  */
+  bool multiply(const BraketOneTerm &L, const vector<MonomialInfo> &info, const vector<MonomialInfo> &linfo, OPMode oper,
+                bool checkidx, BraketOneTerm &out) const;
   /*! \brief negate operator */
   friend BraketOneTerm operator-(const BraketOneTerm &L);
+  /*! \brief Appends the term, as written by operator<<, to out */
+  void appendTo(string &out) const;
   /*! \brief stream operator */
   friend ostream &operator<<(ostream &out, const BraketOneTerm &L);
 };
@@ -180,8 +276,10 @@ class BraketOneTerm {
   \brief Store expression...
 */
 class Braket {
-  /*! \brief Store expressions with b's, b^\daggers and delta's*/
-  vector<BraketOneTerm> expression;
+  /*! \brief Store expressions with b's, b^\daggers and delta's (filled by materialize() if the expression is deferred)*/
+  mutable vector<BraketOneTerm> expression;
+  /*! \brief Deferred operation (see setLazyProducts()), null if @a expression is up to date */
+  mutable shared_ptr<BraketNode> lazy;
   /*! \brief Flag to make the term numeration with ostream operator */
   int flag;
   /*! \brief Store type of operation: none, bra, ket or braket*/
@@ -192,6 +290,62 @@ class Braket {
       evaluated = 1 - > evaluated creating deltas
       evaluated = 2 - > evaluated creating e_(...)... */
 
+  /*! \brief Evaluate every expression term, in parallel if getThreads() > 1, and remove the terms that give zero
+      \param[in] onlydeltas if true evaluate expression to deltas, if false evaluate expression to levi-civita
+      \param[in] method ITERATIVE or WICK
+  */
+  void evaluateTerms(bool onlydeltas, EvalMethod method);
+  /*! \brief Evaluates the expression in chunks within the memory budget (see setEvalMemoryBudget()), spilling the terms
+      to a file and keeping the result in another one, read back by materialize()
+      \param[in] onlydeltas if true evaluate expression to deltas, if false evaluate expression to levi-civita
+      \param[in] method ITERATIVE or WICK
+  */
+  void evaluateSpilled(bool onlydeltas, EvalMethod method);
+  /*! \brief Returns true if the terms are kept in a file by evaluateSpilled() */
+  bool spilled() const;
+  /*! \brief Returns true if the expression is a B operator kept as its factors, see bProduct() */
+  bool implicitB() const;
+  /*! \brief Returns the first operand, this expression included, that is a B operator kept as its factors
+      and reached only through deferred products, or NULL if there is none
+  */
+  const Braket *implicitBop() const;
+  /*! \brief Evaluates a deferred product with a B operator kept as its factors (see implicitBop()) one block of
+      BOP_BLOCK_SIZE monomials of the B operator at a time: each block is expanded, simplified and evaluated
+      before the next one is generated
+      \param[in] onlydeltas if true evaluate expression to deltas, if false evaluate expression to levi-civita
+      \param[in] method ITERATIVE or WICK
+  */
+  void evaluateBlocks(bool onlydeltas, EvalMethod method);
+
+  /*! \brief Writes the expression, numbering the terms with "Local R? = " if numbered is true */
+  void writeTerms(ostream &out, bool numbered) const;
+  /*! \brief Expands the deferred operation, if any, into @a expression */
+  void materialize() const;
+  /*! \brief Appends to out the products of every term of lterms with every term of rterms, skipping
+      the ones that rearrange() followed by simplify() of this expression would remove
+  */
+  void multiplyTerms(const vector<BraketOneTerm> &lterms, const vector<BraketOneTerm> &rterms,
+                     vector<BraketOneTerm> &out) const;
+  /*! \brief Appends the (expanded) terms of the expression to out
+      \param[out] out expanded terms
+      \param[in] bop operand returned by implicitBop(), NULL to expand every B operator whole
+      \param[in] block block of BOP_BLOCK_SIZE monomials of bop taken in place of the whole B operator
+  */
+  void expandTerms(vector<BraketOneTerm> &out, const Braket *bop = NULL, size_t block = 0) const;
+  /*! \brief Applies rearrange() and the rules of simplify() to one new term of this expression
+      \return true if the term must be kept
+  */
+  bool keepTerm(BraketOneTerm &term) const;
+  /*! \brief Replaces the expression by the deferred operation "this op L"
+      \param[in] op '*', '+' or '-'
+      \param[in] L right operand
+  */
+  void defer(char op, const Braket &L);
+  /*! \brief Moves the terms to a node shared by the copies of this expression, so that a deferred operation
+      takes it as operand in O(1); the terms are copied back by materialize() only while they are shared
+  */
+  void share() const;
+
  public:
   /*! \brief Constructor, default expression mode is none */
   Braket(void);
@@ -236,6 +390,16 @@ class Braket {
   ~Braket();
   /*! \brief Clear all allocated memory and sets default parameters */
   void clear();
+  /*! \brief Returns the product (b_1 - b^\dagger_1) ... (b_N - b^\dagger_N) times constval, written directly as its
+      2^N monomials, in the order and with the signs of the expanded product.
+      \param[in] ids indices of the N factors, registered with newIdx()
+      \param[in] constval constant part of every term
+      \param[in] negate if true the signs are reversed
+      \param[in] implicit if true the monomials are not stored: products with the expression are deferred as after
+      setLazyProducts(), and the monomials are generated BOP_BLOCK_SIZE at a time when the product is expanded
+      or evaluated (see setImplicitBop())
+  */
+  static Braket bProduct(const vector<int> &ids, const string &constval, bool negate, bool implicit);
 
   /*! \brief To pass a expression from form */
   void expfromForm(vector<string> a);
@@ -248,8 +412,9 @@ class Braket {
 
   /*! \brief Evaluate expression
       \param[in] onlydeltas if true evaluate expression to deltas, if false evaluate expression to levi-civita
+      \param[in] method ITERATIVE or WICK, the latter only applies to brakets evaluated to deltas
   */
-  void evaluate(bool onlydeltas = true);
+  void evaluate(bool onlydeltas = true, EvalMethod method = ITERATIVE);
   /*! \brief Simplify expression. Apply the following rules:
       \f{eqnarray*}{
      &b_? \left|0\right> = 0 \\
@@ -260,6 +425,11 @@ class Braket {
       This function also calls
   */
   void simplify();
+  /*! \brief Merge like terms. Every term is put in canonical form (see BraketOneTerm::canonicalize()) and
+      terms with the same DLists are replaced by one term with coefficient ((c1)+(c2)+...).
+      Terms without DLists are kept as they are.
+  */
+  void collect();
   /*! \brief Order nodes of DList in Braket
 
       First deltas and then b's and b\\dagger's
@@ -276,6 +446,20 @@ class Braket {
     \return true if |index| is equal to 0 or N of SO(2N), otherwise returns false
   */
   void checkindex();
+  /*! \brief Writes the expression as FORM input, one "Local R? = ...;" per term, the same as operator<< after setON().
+      The terms are formatted by getThreads() threads, in chunks of FORM_WRITER_CHUNK terms written in order.
+  */
+  void writeForm(ostream &out) const;
+  /*! \brief Writes the expression to the binary checkpoint file path, term by term (see BRAKET_FILE_VERSION).
+      The file also keeps the index table and the FORM field declarations and contractions.
+      \return false if the file could not be written
+  */
+  bool save(const string &path) const;
+  /*! \brief Replaces the expression by the one saved in the checkpoint file path.
+      The saved indices and FORM declarations are registered, the indices are renumbered if the index table differs.
+      \return false if the file could not be read, is not a checkpoint, or was saved with another elemType layout or dimension
+  */
+  bool load(const string &path);
   /*! \brief Activate expression term numbering for output writing for each term "Local R?="
    */
   void setON();
@@ -286,6 +470,8 @@ class Braket {
   int size();
   /*! \brief Return expression term at position given by pos*/
   BraketOneTerm &Get(int pos);
+  /*! \brief Return the expression terms at the positions first, ..., last - 1*/
+  Braket slice(int first, int last);
   /*! \brief Return/set the index sum of the term given by pos */
   int &GetIndex(int pos);
 
@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//       coefficient.h created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Constant part of the Braket terms, kept as a rational number times a product of factors.
+*/
+
+#ifndef COEFFICIENT_H
+#define COEFFICIENT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace sospin {
+
+/*!
+  \class Coefficient
+  \brief Constant part of a BraketOneTerm: a rational prefactor times a product of factors (atoms)
+
+  The atoms are FORM expressions taken as a whole, such as "H20(r4,r5)", "e_(i1,i2,i3,i4,i5)", "sqrt(2)" or a sum
+  "(...)". They are shared, not copied, by the products of terms, and the numeric prefactors are multiplied.
+  The FORM text is only built by appendTo()/str(): the prefactor, omitted if it is 1 and there are atoms, followed by
+  the atoms joined by "*". An empty Coefficient (no prefactor written, no atom) gives the empty string.
+*/
+class Coefficient {
+  /*! \brief Numerator of the prefactor */
+  long long num;
+  /*! \brief Denominator of the prefactor, always positive */
+  long long den;
+  /*! \brief True if the prefactor is written, ie, it was given or it comes from a product or negation */
+  bool numeric;
+  /*! \brief Factors, in order */
+  vector<shared_ptr<const string> > atoms;
+
+ public:
+  /*! \brief Constructor, empty coefficient */
+  Coefficient();
+  /*! \brief Constructor from FORM text, blanks are removed.
+      Integers and fractions p/q become the prefactor, any other text is kept as one atom.
+  */
+  Coefficient(const string &text);
+  /*! \brief Returns a coefficient with the single atom text, blanks are kept */
+  static Coefficient atom(const string &text);
+  /*! \brief Returns the sum ((c0)+(c1)-(c2)...) of the addends as one atom, empty addends are written 1
+      \param[in] addends terms of the sum
+      \param[in] signs sign (+1 or -1) of each addend, the sign of the first one is not written
+  */
+  static Coefficient sum(const vector<Coefficient> &addends, const vector<int> &signs);
+
+  /*! \brief Returns true if nothing is written, ie, the coefficient is an implicit 1 */
+  bool empty() const { return !numeric && atoms.empty(); }
+  /*! \brief Returns true if the coefficient is a number */
+  bool isNumber() const { return atoms.empty(); }
+  /*! \brief Returns the coefficient in n/d if it is a number, an empty coefficient is 1
+      \return false if the coefficient has atoms
+  */
+  bool rational(long long &n, long long &d) const;
+  /*! \brief Removes the prefactor and the atoms */
+  void clear();
+  /*! \brief Changes the sign of the prefactor */
+  void negate();
+  /*! \brief Multiplies by c, folding the prefactors and appending the atoms of c */
+  Coefficient &operator*=(const Coefficient &c);
+  /*! \brief Product of two coefficients */
+  friend Coefficient operator*(const Coefficient &a, const Coefficient &b);
+
+  /*! \brief Appends the FORM text of the coefficient to out */
+  void appendTo(string &out) const;
+  /*! \brief Returns the FORM text of the coefficient */
+  string str() const;
+  /*! \brief Estimated memory used by the coefficient, in bytes, counting shared atoms once per coefficient */
+  size_t bytes() const;
+};
+
+}  // namespace sospin
+
+#endif
@@ -36,6 +36,10 @@
 //      License updated
 //      Revision 1.4 12/09/2023 16:53:51 david
 //      Revision 1.5 13/09/2023 17:33:20 david
+//      Revision 1.6 17/10/2026 contiguous storage for the monomial
+//      Revision 1.7 17/10/2026 elemType layout selectable at compile time
+//      Revision 1.8 17/10/2026 MonomialInfo summaries
+//      Revision 1.9 17/10/2026 Canonical form and hash
 
 /*!
   \file
@@ -51,6 +55,7 @@
 #include <list>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace std;
@@ -68,8 +73,14 @@ enum Elem {
   ct = 3      ///< constant element
 };
 
+/*! \def SOSPIN_WIDE_ELEM
+  \brief If defined, DList elements are packed in 64 bits with 24-bit index fields
+  instead of the compact 32-bit layout with 10-bit index fields (at most 1024 indices).
+  Enabled with the CMake option SOSPIN_WIDE_ELEM.
+*/
+
 /**
- * \struct elemtype
+ * \struct basic_elemType
  *
  * \brief struct to store information about one DList element
  *
@@ -92,62 +103,55 @@ enum Elem {
  *
  * Definition for constant:
  * - data.type = 3	:	1, identity
+ *
+ * The fields are packed in one word of type "Word", from the most significant bit:
+ * type (3 bits), sign (1 bit), id.x ("IdxBits" bits), id.y ("IdxBits" bits) and free bits.
  */
-struct elemType {
-  // Type - 3 bits
-  // Sign - 1 bit
-  // id.x - 10 bits
-  // id.y - 10 bits
-  // Free bits - 8 bits
-  // Total - 32 bits
-  unsigned int dataField {0};
-
-  elemType() {}
-
-  elemType(const elemType& elem) {
-    setType(elem.getType());
-    setIdx1(elem.getIdx1());
-    setIdx2(elem.getIdx2());
-  }
+template <class Word, unsigned int IdxBits>
+struct basic_elemType {
+  /*! \brief Number of bits of the packed word.*/
+  static const unsigned int kBits = 8 * sizeof(Word);
+  static const unsigned int kTypeShift = kBits - 3;
+  static const unsigned int kSignShift = kBits - 4;
+  static const unsigned int kIdx1Shift = kBits - 4 - IdxBits;
+  static const unsigned int kIdx2Shift = kBits - 4 - 2 * IdxBits;
+  /*! \brief Mask of one index field, also the largest index that can be stored.*/
+  static const Word kIdxMask = (Word(1) << IdxBits) - 1;
+
+  Word dataField {0};
+
+  basic_elemType() {}
+
+  /*! \brief Returns the number of different indices that fit in one index field.*/
+  static size_t maxIndices() { return size_t(kIdxMask) + 1; }
 
   /*! \brief Returns the type of the element. Ex.: $b$ - type=0; $b^{\dagger}$ - type=1; $\delta$ - type=2; constant - type=3.*/
   unsigned int getType() const {
-    unsigned int type_out;
-    type_out = dataField >> 29;
-    return type_out;
+    return (unsigned int)(dataField >> kTypeShift);
   }
 
   /*! \brief Returns the sign of the element (not used in current version).*/
   bool getSign() const {
-    unsigned int bool_out;
-    bool_out = dataField & 0x10000000;
-    bool_out = bool_out >> 28;
-    return bool_out;
+    return (dataField >> kSignShift) & 1;
   }
 
   /*! \brief Returns the first data field of the element (id.x).*/
   unsigned int getIdx1() const {
-    unsigned int idx1_out;
-    idx1_out = dataField & 0x0FFC0000;
-    idx1_out = idx1_out >> 18;
-    return idx1_out;
+    return (unsigned int)((dataField >> kIdx1Shift) & kIdxMask);
   }
 
   /*! \brief Returns the second data field of the element (id.y).*/
   unsigned int getIdx2() const {
-    unsigned int idx2_out;
-    idx2_out = dataField & 0x0003FF00;
-    idx2_out = idx2_out >> 8;
-    return idx2_out;
+    return (unsigned int)((dataField >> kIdx2Shift) & kIdxMask);
   }
 
   /*! \brief Creates and return an element of type "type" and one data field "data". Second data field is set to zero.*/
-  static elemType make_elem(int type, int data) {
+  static basic_elemType make_elem(int type, int data) {
     if (type == 2) {
       cout << "Cannot make a delta elemType with only one index" << endl;
       exit(0);
     }  // returns error if data.type = 2 (delta)
-    elemType elem;
+    basic_elemType elem;
     elem.setType(type);
     elem.setIdx1(data);
     elem.setIdx2(0);
@@ -155,8 +159,8 @@ struct elemType {
   }
 
   /*! \brief Creates and return an element of type "type" and data fields "data1" and "data2".*/
-  static elemType make_elem(int type, int data1, int data2) {
-    elemType elem;
+  static basic_elemType make_elem(int type, int data1, int data2) {
+    basic_elemType elem;
     elem.setType(type);
     elem.setIdx1(data1);
     elem.setIdx2(data2);
@@ -164,123 +168,124 @@ struct elemType {
   }
 
   /*! \brief Creates and return $\delta$ element using first data field of elements "a" and "b".*/
-  static elemType make_delta(elemType data1, elemType data2) {
-    elemType elem;
+  static basic_elemType make_delta(basic_elemType data1, basic_elemType data2) {
+    basic_elemType elem;
     elem.setType(2);
     elem.setIdx1(data1.getIdx1());
     elem.setIdx2(data2.getIdx1());
     return elem;
   }
 
-  /*! \brief Sets the type of the element.*/
+  /*! \brief Sets the type of the element. All types above 3 are stored as 4 (not used).*/
   void setType(unsigned int typ) {
-
-    // Clean 3-bits of type
-    dataField = dataField & 0x1FFFFFFF;
-
-    // Set type
-    // b
-    if (typ == 0) dataField = dataField | 0x00000000;
-    // b^\dagger
-    if (typ == 1) dataField = dataField | 0x20000000;
-    // delta
-    if (typ == 2) dataField = dataField | 0x40000000;
-    // constant
-    if (typ == 3) dataField = dataField | 0x60000000;
-    // For all other types (not used)
-    if (typ > 3) dataField = dataField | 0x80000000;
+    if (typ > 3) typ = 4;
+    // Clean 3-bits of type and set type
+    dataField = (dataField & ~(Word(7) << kTypeShift)) | (Word(typ) << kTypeShift);
   }
 
   /*! \brief Sets sign field of the element (not used in current version).*/
   void setSign(bool sign) {
-    // Clean bit of sign
-    dataField = dataField & 0xEFFFFFFF;
-
-    // Set sign (only if sign is true)
-    if (sign == 1) dataField = dataField | 0x10000000;
+    // Clean bit of sign and set it only if sign is true
+    dataField = (dataField & ~(Word(1) << kSignShift)) | (Word(sign) << kSignShift);
   }
 
   /*! \brief Sets first data field of the element (idx1).*/
   void setIdx1(unsigned int idx) {
-    unsigned int in;
-
-    // Clean bits of data1 field
-    dataField = dataField & 0xF003FFFF;
-
-    // Format in to accommodate 10 bits from the input
-    in = idx & 0x000003FF;
-
-    // Shift to match filled bits
-    in = in << 18;
-
-    // Set data1 field
-    dataField = dataField | in;
+    dataField = (dataField & ~(kIdxMask << kIdx1Shift)) | ((Word(idx) & kIdxMask) << kIdx1Shift);
   }
 
   /*! \brief Sets second data field of the element (idx2).*/
   void setIdx2(unsigned int idx) {
-    unsigned int in;
-
-    // Clean bits of data2 field
-    dataField = dataField & 0xFFFC00FF;
-
-    // Format in to accommodate 10 bits from the input
-    in = idx & 0x000003FF;
-
-    // Shift to match filled bits
-    in = in << 8;
-
-    // Set data2 field
-    dataField = dataField | in;
-  }
-
-  /*! \brief Makes a copy of an element.*/
-  elemType& operator=(const elemType& elem) {
-    // elemType aux=elem;
-    setType(elem.getType());
-    setIdx1(elem.getIdx1());
-    setIdx2(elem.getIdx2());
-    return *this;
+    dataField = (dataField & ~(kIdxMask << kIdx2Shift)) | ((Word(idx) & kIdxMask) << kIdx2Shift);
   }
 };
 
+#ifdef SOSPIN_WIDE_ELEM
+// Type - 3 bits
+// Sign - 1 bit
+// id.x - 24 bits
+// id.y - 24 bits
+// Free bits - 12 bits
+// Total - 64 bits
+typedef basic_elemType<unsigned long long, 24> elemType;
+#else
+// Type - 3 bits
+// Sign - 1 bit
+// id.x - 10 bits
+// id.y - 10 bits
+// Free bits - 8 bits
+// Total - 32 bits
+typedef basic_elemType<unsigned int, 10> elemType;
+#endif
+
+// DList moves its elements with memcpy/memmove
+static_assert(std::is_trivially_copyable<elemType>::value, "elemType must be trivially copyable");
+
 /*!
-  \struct noList
-  \brief struct for the node of DList
- */
-struct noList {
-  /*! \brief Store symbol type.*/
-  elemType data;
-  /*! \brief Pointer to the previous (@a prv) node.*/
-  noList* prv;
-  /*! \brief Pointer to the next (@a nxt) node.*/
-  noList* nxt;
+  \struct MonomialInfo
+  \brief Summary of a DList, enough to know whether a product of two DLists is removed by simplify() without building it
+*/
+struct MonomialInfo {
+  int nb;       ///< number of b's
+  int nbt;      ///< number of b^\dagger's
+  int first;    ///< type of the first b or b^\dagger, -1 if there is none
+  int last;     ///< type of the last b or b^\dagger, -1 if there is none
+  bool deltas;  ///< false if some delta is zero, as in DList::checkDeltaIndex()
 };
 
+/*! \def DLIST_INLINE_SIZE
+  \brief Number of elements stored inside the DList object itself before spilling to the heap
+*/
+#ifndef DLIST_INLINE_SIZE
+#define DLIST_INLINE_SIZE 16
+#endif
+
 /*!
   \class DList Class
-  \brief DList with nodes
+  \brief DList with contiguous storage
+
+  The monomial is stored as a contiguous array of elemType. Up to DLIST_INLINE_SIZE elements
+  are kept inline in the object, longer monomials move to a heap buffer. The "actual" cursor
+  is an array position, -1 meaning that it does not point to any element.
  */
 class DList {
-  /*! \brief Pointer to the first node.*/
-  noList* begin;
-  /*! \brief Pointer to the last node.*/
-  noList* end;
-  /*! \brief Pointer to the actual node.*/
-  noList* actual;
+  /*! \brief Inline storage for short monomials.*/
+  elemType local[DLIST_INLINE_SIZE];
+  /*! \brief Pointer to the first element (either @a local or a heap buffer).*/
+  elemType* data;
+  /*! \brief Number of elements.*/
+  unsigned int length;
+  /*! \brief Number of elements that fit in @a data.*/
+  unsigned int capacity;
+  /*! \brief Position of the actual element, -1 if none.*/
+  int actual;
   /*! \brief Store the sign of the monomial.*/
   int sign;
 
+  /*! \brief Makes room for at least "n" elements, keeping the current ones.*/
+  void reserve(unsigned int n);
+
+  /*! \brief Copies elements and sign of L, the actual position is set to the last element.*/
+  void assign(const DList& L);
+
+  /*! \brief Removes "n" elements starting at position "pos".*/
+  void erase(unsigned int pos, unsigned int n);
+
+  /*! \brief Position of the last element, -1 if DList is empty.*/
+  int last() const {
+    return static_cast<int>(length) - 1;
+  }
+
  public:
   // Constructors and destructor
 
   /*! \brief Default constructor*/
   DList(void);
 
-  /*! \brief Constructor - node of element of type "tp" and first data field "i". Pointer are initialized with NULL.*/
+  /*! \brief Constructor - DList with one element of type "tp" and first data field "i".*/
   DList(int tp, int i);
 
-  /*! \brief Constructor - node of element of type "tp", first data field "i" and second data field "j". Pointer are initialized with NULL.*/
+  /*! \brief Constructor - DList with one element of type "tp", first data field "i" and second data field "j".*/
   DList(int tp, int i, int j);
 
   /*! \brief Constructor by copy.*/
@@ -291,7 +296,7 @@ class DList {
 
   // Changing, writing and updating
 
-  /*! \brief Deletes all nodes from DList.*/
+  /*! \brief Deletes all elements from DList.*/
   void clear();
 
   /*! \brief Changes the sign of DList.*/
@@ -310,17 +315,17 @@ class DList {
 
   /*! \brief Sets data (elemtype) of the node being pointed by actual pointer.*/
   void set(elemType i) {
-    actual->data = i;
+    data[actual] = i;
   }
 
   /*! \brief Changes actual pointer to point at the first element of DList (beg pointer).*/
   void set_begin() {
-    actual = begin;
+    actual = length ? 0 : -1;
   }
 
   /*! \brief Changes actual pointer to point at the last element of DList (end pointer).*/
   void set_end() {
-    actual = end;
+    actual = last();
   }
 
   /*! \brief Sets the sign of DList.*/
@@ -333,20 +338,30 @@ class DList {
 
   /*! \brief Shifts actual pointer to next node. If actual node is the end node, shift to beg node.*/
   void loop_right() {
-    if (actual == 0 || actual->nxt == 0)
-      actual = begin;
+    if (actual < 0 || actual == last())
+      set_begin();
     else
-      actual = actual->nxt;
+      actual++;
   }
 
   /*! \brief Shifts actual pointer to previous node. If actual node is the beg node, shift to end node.*/
   void loop_left() {
-    actual = actual->prv;
-    if (actual == 0) actual = end;
+    actual--;
+    if (actual < 0) actual = last();
   }
 
   /*! \brief Creates and returns a new DList by copying nodes in DList ordered by type. The nodes that first appear in the new ordered DList are $\delta$'s (type=2) and then all other elements: $b$ (type=0) and $b^\dagger$ (type=1) unordered. Constant elements are removed.*/
-  DList rearrange();
+  DList rearrange() const;
+
+  /*! \brief Returns rearrange() with the indices of each $\delta$ in increasing order and the $\delta$'s sorted,
+      so that equal monomials have the same elements.*/
+  DList canonical() const;
+
+  /*! \brief Returns a 64-bit hash of the elements of the DList, the sign is not included.*/
+  unsigned long long hash() const;
+
+  /*! \brief Returns true if both DLists have the same elements, regardless of their signs.*/
+  bool sameElements(const DList& M) const;
 
   /*! \brief Removes the first element with "data.get\_type()==type" found in DList. Updates actual pointer to be the first node.*/
   void remove(unsigned int type);
@@ -356,16 +371,16 @@ class DList {
 
   /*! \brief Shifts actual pointer to next node. If actual node is the end node, stops.*/
   void shift_right() {
-    if (actual == 0 || actual->nxt == 0)
-      actual = end;
+    if (actual < 0 || actual == last())
+      actual = last();
     else
-      actual = actual->nxt;
+      actual++;
   }
 
   /*! \brief Shifts actual pointer to previous node. If actual node if first node (begin), stops.*/
   void shift_left() {
-    actual = actual->prv;
-    if (actual == 0) actual = begin;
+    actual--;
+    if (actual < 0) set_begin();
   }
 
   /*! \brief Swaps the actual node with the next node of DList.*/
@@ -375,11 +390,11 @@ class DList {
 
   /*! \brief Returns elemtype of the node being pointed by actual (current element).*/
   elemType get() {
-    return actual->data;
+    return data[actual];
   }
 
   /*! \brief Returns the sign of DList.*/
-  int getSign() {
+  int getSign() const {
     return sign;
   }
 
@@ -421,6 +436,9 @@ class DList {
   /*! \brief Checks the indexes of $\delta$ elements. They must be less or equal to the n of SO(2n). Checks also if the the indexes of a delta are equal. Returns true if each $\delta$ is not zero, false otherwise.*/
   bool checkDeltaIndex();
 
+  /*! \brief Returns the summary of the DList used to predict vanishing products.*/
+  MonomialInfo info() const;
+
   /*! \brief Verifies if the number of $b$'s and $b^\dagger$'s is less or equal than N of SO(2N). Returns true if so, false otherwise.*/
   bool check_num();
 
@@ -429,14 +447,22 @@ class DList {
 
   /*! \brief Returns true if actual pointer is pointing to the last (end) node of DList.*/
   bool isActualLast() {
-    return (actual == end) ? true : false;
+    return (actual == last()) ? true : false;
   }
 
   /*! \brief Returns true if DList has no nodes.*/
   bool isEmpty() {
-    bool epty = true;
-    if (begin != 0) epty = false;
-    return epty;
+    return length == 0;
+  }
+
+  /*! \brief Returns the number of elements in DList.*/
+  unsigned int size() const {
+    return length;
+  }
+
+  /*! \brief Returns the element at position "pos" (no bounds check).*/
+  const elemType& at(unsigned int pos) const {
+    return data[pos];
   }
 
   /*! \brief Returns true if there is no elements of type $\delta$ in DList.*/
@@ -484,6 +510,17 @@ class DList {
   */
   friend DList ordering(DList& L, bool braketmode);
 
+  /*! \brief Vacuum expectation value of a monomial by Wick's theorem.
+    Every b is paired with a b^\dagger at its right, each pairing gives
+    \f{eqnarray*}{
+    \left<0\right| b_{i_1} ... b^\dagger_{j_1} ... \left|0\right> = \pm \delta_{i_1,j_1} ...
+    \f}
+    with the sign of the permutation that brings every pair together.
+    @param[in] L, DList term to be processed, deltas and constants are kept
+    @param[out] out, one DList with only deltas (and constants) is appended for each non vanishing pairing
+  */
+  friend void wick_contract(const DList& L, vector<DList>& out);
+
   /*! \brief Creates and returns a string with the deltas and constants of a DList.*/
   friend string printDeltas(DList& L);
 
@@ -53,6 +53,15 @@ typedef enum OPMode_s {
   braket
 } OPMode;
 
+/*!
+  \enum Enumerator for the evaluation method
+  \brief Enumerator for the evaluation method of Braket::evaluate
+*/
+typedef enum EvalMethod_s {
+  ITERATIVE,  // swap one pair of b and b^dagger at a time
+  WICK        // vacuum expectation values by Wick's theorem (brakets evaluated to deltas only)
+} EvalMethod;
+
 /*!
   \enum Enumerator for verbosity
   \brief Enumerator for verbosity
@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+//       fock.h created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Fock space states of the N modes of SO(2N), used to evaluate the brakets whose indices are all numbers.
+*/
+
+#ifndef FOCK_H
+#define FOCK_H
+
+#include <sospin/dlist.h>
+
+#include <map>
+
+using namespace std;
+
+namespace sospin {
+
+/*!
+  \class FockState
+  \brief State of the N fermionic modes of SO(2N): a sparse sum of occupation states with integer coefficients.
+
+  Bit k-1 of an occupation mask is set if mode k is occupied. b^\dagger_k and b_k act as
+  \f{eqnarray*}{
+  b^\dagger_k |n\rangle = (-1)^{n_1+...+n_{k-1}} |n + 1_k\rangle, \quad b_k |n\rangle = (-1)^{n_1+...+n_{k-1}} |n - 1_k\rangle
+  \f}
+  and give zero when mode k is already occupied (b^\dagger_k) or empty (b_k), so that they anticommute as b and b^\dagger.
+  Applying a monomial with numeric indices to the vacuum gives \f$\langle 0| monomial |0\rangle\f$ without
+  rewriting it into deltas.
+*/
+class FockState {
+ public:
+  typedef unsigned long long Mask;
+
+  /*! \brief The zero state */
+  FockState() {}
+  /*! \brief The vacuum |0> */
+  static FockState vacuum();
+
+  /*! \brief Applies b^\dagger_k, k = 1, ..., 64 */
+  void create(int k);
+  /*! \brief Applies b_k, k = 1, ..., 64 */
+  void annihilate(int k);
+  /*! \brief Applies the monomial d, from its last element to the first one, deltas included, without its sign.
+      Modes and deltas with a number above N of SO(2N) give zero, as in DList::checkDeltaIndex().
+      \return false if an index of d is not a number, the state is then unchanged
+  */
+  bool apply(const DList &d);
+  /*! \brief Adds factor * s to the state */
+  void add(const FockState &s, long long factor);
+
+  /*! \brief Returns the coefficient of the occupation state m */
+  long long amplitude(Mask m) const;
+  /*! \brief Returns true if the state is zero */
+  bool empty() const { return amp.empty(); }
+  /*! \brief Returns the number of occupation states with a coefficient */
+  size_t size() const { return amp.size(); }
+
+ private:
+  /*! \brief Coefficients of the occupation states, zeros are not kept */
+  map<Mask, long long> amp;
+};
+
+/*! \brief Returns true if every index of d is a number, see FockState::apply() */
+bool isNumeric(const DList &d);
+
+}  // namespace sospin
+
+#endif
@@ -32,6 +32,7 @@
 //
 //      Revision 1.1 28/02/2015 23:19:29 david
 //      Revision 1.2 12/09/2023 16:53:51 david
+//      Revision 1.3 17/10/2026 FORM session
 
 /*!
   \file
@@ -42,6 +43,7 @@
 #define FORM_H
 
 #include <sospin/braket.h>
+#include <sospin/formcache.h>
 #include <sospin/index.h>
 
 #include <cstdlib>
@@ -85,6 +87,29 @@ void setFormIndexSum();
  */
 void unsetFormIndexSum();
 
+/*! \brief Splits the expression in k batches of terms simplified by k FORM processes running in parallel,
+    followed by one FORM pass summing the k partial results (files form_1_in.frm, ..., form_k_in.frm).
+    Ignored while a FORM session is running.
+
+    By default k is 1, ie, one FORM process simplifies the whole expression.
+*/
+void setFormShards(int k);
+/*! \brief Runs one FORM process on the whole expression.
+ */
+void unsetFormShards();
+
+/*! \brief Keeps the results of CallForm in the directory dir, keyed by a hash of the FORM program,
+    and reads them back instead of running FORM again for the same program.
+    The least recently used results are removed when the directory exceeds maxbytes.
+    \param[in] dir cache directory, created if missing
+    \param[in] maxbytes size limit of the cached results, in bytes
+*/
+void setFormCache(string dir = "form_cache", unsigned long long maxbytes = 1ULL << 30);
+/*! \brief Stops using the FORM result cache, the cached files are kept */
+void unsetFormCache();
+/*! \brief Returns the FORM result cache (see FormCache) */
+const FormCache &getFormCache();
+
 /*! \brief Function to add field name and create field proprieties to FORM input file.
     \param[in] fieldname, name of the field
     \param[in] numUpperIds, number of upper indices
@@ -105,6 +130,39 @@ string FormField(const string fieldname, const unsigned int numUpperIds, const u
 */
 void CallForm(Braket &exp, bool print = true, bool all = true, string newidlabel = "j");
 
+/*! \brief Starts a FORM process kept alive and used by every following CallForm, instead of running FORM
+    once per call through the shell and the files form_in.frm/form_out.frm (see FormSession).
+    \param[in] program FORM binary, or a program speaking the same protocol; if empty FORM is found as in CallForm
+*/
+void startFormSession(string program = "");
+/*! \brief Stops the FORM session, CallForm runs FORM once per call again */
+void stopFormSession();
+/*! \brief Returns true if CallForm uses the FORM session */
+bool formSessionRunning();
+
+/*! \brief FORM output read by ParseFormOutput */
+struct FormOutput {
+  /*! \brief FORM output with the dummy indices N?_? renamed */
+  string text;
+  /*! \brief Position of "R =" in text, string::npos if FORM gave no result */
+  size_t result;
+  /*! \brief Position in text after the ';' ending the result */
+  size_t resultEnd;
+  /*! \brief Terms of the result, without blanks, split at the signs outside parentheses */
+  vector<string> terms;
+  /*! \brief The result "R = ...;" as written by FORM, before the indices are renamed */
+  string raw;
+};
+
+/*! \brief Reads the FORM output [begin, end) in a single pass.
+    The dummy indices N?_? are renamed newidlabel? and registered with newId(), and the result "R = ...;"
+    is split in terms, each one but the first starting with its sign, ready for Braket::expfromForm.
+    \param[in] begin first character of the FORM output
+    \param[in] end one past the last character of the FORM output
+    \param[in] newidlabel label of the renamed indices
+*/
+FormOutput ParseFormOutput(const char *begin, const char *end, const string &newidlabel);
+
 /*!
   \class ToForm class
   \brief Container for form specifications
@@ -136,6 +194,11 @@ class ToForm {
   */
   bool indexSum;
 
+  /*!
+  \brief Number of FORM processes run in parallel by Formrun, each one on a batch of the expression terms
+  */
+  int shards;
+
  public:
   /*! \brief Constructor */
   ToForm(void);
@@ -155,6 +218,10 @@ class ToForm {
     \brief Returns all the field names
   */
   string getFunction();
+  /*! \brief Returns the stored field names, one per entry */
+  const vector<string> &getFunctionList() const { return Functions; }
+  /*! \brief Returns the stored field contractions, one per entry */
+  const vector<string> &getFCList() const { return FormContraction; }
 
   /*!
     \brief Sets the beginning of a input/output FORM file
@@ -196,6 +263,10 @@ class ToForm {
   void setRenumber(bool flag = true);
   /*! Returns the state of the formRenumber flag  */
   bool getRenumberOption();
+  /*! Sets the number of FORM processes run in parallel, 1 runs a single FORM process */
+  void setShards(int k);
+  /*! Returns the number of FORM processes run in parallel */
+  int getShards();
 
   ToForm &operator<<(const string &func);
   ToForm &operator+(const string &func);
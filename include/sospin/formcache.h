@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//       formcache.h created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief On-disk cache of FORM results, keyed by the FORM program.
+*/
+
+#ifndef FORMCACHE_H
+#define FORMCACHE_H
+
+#include <streambuf>
+#include <string>
+
+using namespace std;
+
+namespace sospin {
+
+/*!
+  \class FormCache
+  \brief Directory of FORM results addressed by the content of the FORM program
+
+  Each result is stored in "<directory>/<key>.frc", where key() hashes the FORM program (declarations, index list,
+  contractions, options and expression). The file holds the text "R = ...;" written by FORM, before the dummy indices
+  are renamed, so reading it back renames and registers the indices as a FORM run would.
+  When the files exceed the size limit, the least recently used ones are removed.
+*/
+class FormCache {
+  /*! \brief Cache directory, empty if the cache is not used */
+  string directory;
+  /*! \brief Size limit of the cached files, in bytes */
+  unsigned long long maxBytes;
+  /*! \brief Number of lookups found in the cache */
+  unsigned long nhits;
+  /*! \brief Number of lookups not found in the cache */
+  unsigned long nmisses;
+
+  /*! \brief Returns the file of the given key */
+  string path(const string &key) const;
+
+ public:
+  /*! \brief Constructor, the cache is only used after open() */
+  FormCache();
+
+  /*! \brief Uses directory (created if missing) for the following lookups and stores
+      \param[in] dir cache directory
+      \param[in] maxbytes size limit of the cached files, in bytes
+      \return false if the directory could not be created
+  */
+  bool open(const string &dir, unsigned long long maxbytes);
+  /*! \brief Stops using the cache, the files are kept */
+  void close();
+  /*! \brief Returns true if the cache is used */
+  bool isOpen() const { return !directory.empty(); }
+
+  /*! \brief Reads the result stored with key
+      \param[in] key key() of the FORM program
+      \param[out] result FORM result "R = ...;"
+      \return false if key is not in the cache
+  */
+  bool lookup(const string &key, string &result);
+  /*! \brief Stores the result of key, then removes the least recently used files above the size limit */
+  void store(const string &key, const string &result);
+  /*! \brief Removes the least recently used files until the cache fits in the size limit */
+  void evict();
+
+  /*! \brief Number of lookups found in the cache */
+  unsigned long hits() const { return nhits; }
+  /*! \brief Number of lookups not found in the cache */
+  unsigned long misses() const { return nmisses; }
+
+  /*! \brief Returns the key of a FORM program: two 64-bit FNV-1a hashes and the length, in hexadecimal */
+  static string key(const string &program);
+
+  /*!
+    \class Hasher
+    \brief Output buffer computing key() of the characters written to it, optionally passed on to another buffer
+  */
+  class Hasher : public streambuf {
+    /*! \brief Buffer receiving the characters, 0 if they are only hashed */
+    streambuf *out;
+    unsigned long long h0, h1, length;
+
+   protected:
+    int_type overflow(int_type c);
+    streamsize xsputn(const char *s, streamsize n);
+    int sync();
+
+   public:
+    /*! \brief Constructor
+        \param[in] next buffer receiving the hashed characters (for example the one of the FORM input file), 0 to drop them
+    */
+    explicit Hasher(streambuf *next = 0);
+    /*! \brief Returns key() of the characters written so far */
+    string key() const;
+  };
+};
+
+}  // namespace sospin
+
+#endif
@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//       formsession.h created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Persistent FORM process driven through FORM's external channel (-pipe).
+*/
+
+#ifndef FORMSESSION_H
+#define FORMSESSION_H
+
+#include <string>
+
+using namespace std;
+
+namespace sospin {
+
+/*!
+  \class FormSession
+  \brief A FORM process started once and fed with programs over pipes
+
+  The program is started as "program -q -pipe r,w initfile", where r and w are the pipe descriptors
+  FORM reads from and writes to. The protocol is the one of FORM's external channel:
+
+  - handshake: FORM writes its PID on a line, the session answers "<FORM PID>,<own PID>" followed by an empty line;
+  - the FORM program (initProgram()) loops over "#fromexternal", so every text sent, terminated by an empty line (the default
+    prompt), is read and executed by the FORM preprocessor; the text must not contain empty lines;
+  - results are written back by the program with "#toexternal" and each answer ends with a line
+    containing only FormSession::endMark().
+
+  Any executable that speaks this protocol can be used instead of FORM (see test/form_stub.cpp).
+*/
+class FormSession {
+  /*! \brief Process id of FORM, -1 if not running */
+  int pid;
+  /*! \brief Descriptor used to write to FORM */
+  int towrite;
+  /*! \brief Descriptor used to read from FORM */
+  int toread;
+  /*! \brief Data read from FORM and not yet returned */
+  string pending;
+
+  /*! \brief Reads one line from FORM (without the newline), returns false on end of file */
+  bool readLine(string &line);
+
+ public:
+  /*! \brief Constructor, the process is only started by start() */
+  FormSession();
+  /*! \brief Destructor, stops the process */
+  ~FormSession();
+  FormSession(const FormSession &) = delete;
+  FormSession &operator=(const FormSession &) = delete;
+
+  /*! \brief Starts the program and makes the handshake
+      \param[in] program path to the FORM binary (or a program speaking the same protocol)
+      \param[in] initfile file where initProgram(), the program run by FORM, is written
+      \param[in] logfile file receiving the standard output of FORM
+      \return false if the program could not be started
+  */
+  bool start(const string &program, const string &initfile, const string &logfile);
+  /*! \brief Returns true if the process is running */
+  bool isRunning() const { return pid > 0; }
+  /*! \brief Sends a piece of FORM program, followed by the prompt */
+  void send(const string &text);
+  /*! \brief Reads the next answer, up to the line with endMark()
+      \param[out] out answer without the end mark
+      \return false if FORM closed the channel before the end mark
+  */
+  bool receive(string &out);
+  /*! \brief Closes the channel and waits for the process */
+  void stop();
+
+  /*! \brief Line that ends every answer sent back with "#toexternal" */
+  static const char *endMark() { return "#SOSPIN-END#"; }
+  /*! \brief Returns the FORM program that executes every text received from the external channel */
+  static string initProgram();
+};
+
+}  // namespace sospin
+
+#endif
@@ -54,8 +54,8 @@ using namespace std;
 
 namespace sospin {
 
-/*! \brief Vector container of the indexes.*/
-extern vector<string> tabids;
+/*! \brief Vector container of the indexes, read only: indices are added with newIdx/newId and removed with clearIdx.*/
+extern const vector<string>& tabids;
 
 /*! \brief Store new index of type "int".*/
 int newIdx(int i);
@@ -66,12 +66,18 @@ int newIdx(string i);
 /*! \brief Return index in position @ the position "i".*/
 string getIdx(int i);
 
+/*! \brief Return the numeric value of the index in position "i", 0 if the index is symbolic.*/
+int getIdxValue(int i);
+
 /*! \brief Return index list in string of the form "Indices ?,...,?".*/
 string IndexList();
 
 /*! \brief Store new index of type "string".*/
 void newId(string i);
 
+/*! \brief Remove all the indices.*/
+void clearIdx();
+
 /*! \brief Return index list size.*/
 int Idx_size();
 
@@ -33,26 +33,141 @@
 //      Revision 1.1 28/02/2015 23:19:29 david
 //      License updated
 //      Revision 1.2 12/09/2023 16:53:51 david
+//      Revision 1.3 17/10/2026 progress counters and reporter thread
 
 /*!
   \file
-  \brief Specific functions progress status bar.
+  \brief Progress of the library loops: counters updated by the loops and a reporter thread writing them to a sink.
 */
 
 #ifndef PROGRESSSTATUS_H_DEF
 
 #define PROGRESSSTATUS_H_DEF
 
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 
 namespace sospin {
 
+/*! \def PROGRESS_INTERVAL
+  \brief Default time in milliseconds between two reports of the progress, see setProgressInterval()
+*/
+#ifndef PROGRESS_INTERVAL
+#define PROGRESS_INTERVAL 250
+#endif
+
+/*!
+  \class ProgressSink
+  \brief Receives the progress of the library loops (rearrange, checkindex, simplify, evaluate, ...), see setProgressSink().
+  The calls are serialized: report() is called by the reporter thread, finish() by the thread ending the loop.
+*/
+class ProgressSink {
+ public:
+  virtual ~ProgressSink() {}
+  /*! \brief Called every setProgressInterval() milliseconds while a loop runs and its step changed */
+  virtual void report(const char *label, size_t step, size_t total) = 0;
+  /*! \brief Called once when a loop ends */
+  virtual void finish(const char *label, size_t total) = 0;
+};
+
+/*! \brief Progress bar redrawn in the terminal with ANSI escapes, kept at the end of the loops with setVerbosity(VERBOSE).
+    This is the default sink.
+*/
+class TerminalProgress : public ProgressSink {
+ public:
+  void report(const char *label, size_t step, size_t total);
+  void finish(const char *label, size_t total);
+};
+
+/*! \brief One plain line "label 42% (420/1000)" per report, without terminal escapes, for batch jobs */
+class LogProgress : public ProgressSink {
+ public:
+  /*! \param[in] out stream receiving the lines, it must outlive the sink */
+  LogProgress(std::ostream &out = std::cerr) : out(out) {}
+  void report(const char *label, size_t step, size_t total);
+  void finish(const char *label, size_t total);
+
+ private:
+  std::ostream &out;
+};
+
+/*! \brief Calls a function with the label, the step and the total, the step is equal to the total when the loop ends */
+class CallbackProgress : public ProgressSink {
+ public:
+  typedef std::function<void(const char *, size_t, size_t)> Callback;
+  CallbackProgress(Callback f) : f(f) {}
+  void report(const char *label, size_t step, size_t total) { f(label, step, total); }
+  void finish(const char *label, size_t total) { f(label, total, total); }
+
+ private:
+  Callback f;
+};
+
+/*! \brief Sets the sink receiving the progress, a null sink reports nothing.
+    The progress is only reported when the verbosity is not SILENT.
+\code
+setProgressSink(std::make_shared<LogProgress>(logfile));
+\endcode
+*/
+void setProgressSink(std::shared_ptr<ProgressSink> sink);
+/*! \brief Returns the sink receiving the progress */
+std::shared_ptr<ProgressSink> getProgressSink();
+/*! \brief Sets the time between two reports of the progress, in milliseconds (default PROGRESS_INTERVAL) */
+void setProgressInterval(unsigned int milliseconds);
+
+/*!
+  \class Progress
+  \brief Progress of one loop, from its construction to its destruction.
+  The loop only updates an atomic counter, from one or several threads; while the verbosity is not SILENT
+  a reporter thread reads it every setProgressInterval() milliseconds and writes it to the sink.
+  Nested loops are reported by the innermost one.
+\code
+Progress progress("Progress: ", total);
+for (size_t i = 0; i < total; i++) {
+  ...
+  progress.set(i + 1);
+}
+\endcode
+*/
+class Progress {
+ public:
+  /*! \param[in] label text written before the progress, a string literal or any text outliving the loop
+      \param[in] total number of steps of the loop
+  */
+  Progress(const char *label, size_t total);
+  /*! \brief Reports the end of the loop */
+  ~Progress();
+  /*! \brief Sets the number of steps done */
+  void set(size_t step) { current.store(step, std::memory_order_relaxed); }
+  /*! \brief Adds n steps done, safe from several threads */
+  void add(size_t n = 1) { current.fetch_add(n, std::memory_order_relaxed); }
+  /*! \brief Returns the number of steps done */
+  size_t step() const { return current.load(std::memory_order_relaxed); }
+  /*! \brief Returns the number of steps of the loop */
+  size_t total() const { return count; }
+  /*! \brief Returns the label */
+  const char *label() const { return name; }
+
+ private:
+  Progress(const Progress &);
+  Progress &operator=(const Progress &);
+  const char *name;
+  size_t count;
+  std::atomic<size_t> current;
+  /*! \brief true while the reporter thread reads this loop */
+  bool reported;
+};
+
+/*! \brief Prints the progress bar at step, each 10 steps. Not used by the library anymore, see Progress */
 void DoProgress(std::string label, unsigned int step, unsigned int total);
 
+/*! \brief Prints the progress bar at step, each print_at_steps steps. Not used by the library anymore, see Progress */
 void DoProgress(std::string label, unsigned int step, unsigned int total, unsigned int print_at_steps);
 
 }  // namespace sospin
@@ -50,11 +50,15 @@
 #ifndef SON_H
 #define SON_H
 
+#include <sospin/arena.h>
 #include <sospin/braket.h>
 #include <sospin/dlist.h>
 #include <sospin/enum.h>
+#include <sospin/fock.h>
 #include <sospin/form.h>
 #include <sospin/index.h>
+#include <sospin/progressStatus.h>
+#include <sospin/stats.h>
 #include <sospin/timer.h>
 
 #if DOXYGEN
@@ -168,12 +172,39 @@ void setVerbosity(Verbosity verb);
 */
 Verbosity getVerbosity();
 
+/*!
+  \brief Set the number of threads used by Braket::evaluate
+  \param n number of threads, 0 uses all hardware threads (default 1)
+*/
+void setThreads(int n);
+
+/*!
+  \brief Return the number of threads used by Braket::evaluate
+*/
+int getThreads();
+
 /*!
   \brief Return current ostream verbosity level
   \return ostream for output
 */
 ostream& operator<<(ostream& out, const Verbosity& a);
 
+/*!
+  \brief Bop() and BopIdnum() return the B operator kept as its N factors (b_k - b^\dagger_k), see Braket::bProduct().
+  Products with it are deferred; Braket::evaluate() expands, simplifies and evaluates them one block of BOP_BLOCK_SIZE
+  monomials of B at a time, so neither the 2^N monomials nor the whole unevaluated product are stored.
+  Other uses of the product (size(), Get(), printing, ...) expand it whole, a block at a time, and only save the
+  monomials of B. The terms follow the order of the expanded product within each block: once 2^N > BOP_BLOCK_SIZE
+  the term order differs from the one obtained without this option.
+  This option is deactivated by default.
+*/
+void setImplicitBop();
+
+/*!
+  \brief Bop() and BopIdnum() return the 2^N monomials of the B operator (default)
+*/
+void unsetImplicitBop();
+
 // Braket BopN1();
 Braket Bop(std::string startid = "i");
 Braket BopIdnum();
@@ -0,0 +1,141 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+//       stats.h created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Call counts, times and term counts of the library phases (rearrange, simplify, evaluation, FORM).
+*/
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace sospin {
+
+/*!
+  \enum Phase
+  \brief Library phases measured by PhaseScope
+*/
+enum Phase {
+  PHASE_REARRANGE,       // Braket::rearrange
+  PHASE_CHECKINDEX,      // Braket::checkindex
+  PHASE_SIMPLIFY,        // Braket::simplify, checkindex included
+  PHASE_EVAL_DELTAS,     // BraketOneTerm::EvaluateToDeltas
+  PHASE_REDUCE_B,        // ReduceNumberOfBandBdaggers
+  PHASE_ORDER_B,         // OrderBandBdaggers
+  PHASE_EPS_2NDPASS,     // BraketOneTerm::EvaluateEps_2ndPass
+  PHASE_EVAL_FOCK,       // BraketOneTerm::EvaluateFock
+  PHASE_FORM_WRITE,      // FORM program written from a Braket
+  PHASE_FORM_EXEC,       // FORM run, through the shell or the FORM session
+  PHASE_FORM_PARSE,      // ParseFormOutput
+  PHASE_COUNT
+};
+
+/*! \brief Counters of one phase, see getPhaseStats() */
+struct PhaseStats {
+  /*! \brief Name of the phase */
+  string name;
+  /*! \brief Number of calls */
+  unsigned long long calls;
+  /*! \brief Wall time in seconds, from a monotonic clock, nested phases included */
+  double wall;
+  /*! \brief CPU time in seconds of the threads running the phase */
+  double cpu;
+  /*! \brief Terms (or monomials, for the phases of one term) received */
+  unsigned long long termsIn;
+  /*! \brief Terms (or monomials) returned, termsOut/termsIn is the blow-up factor of the phase */
+  unsigned long long termsOut;
+};
+
+/*! \brief Returns the counters of every phase, in the order of Phase.
+    Built without SOSPIN_STATS (cmake -DSOSPIN_STATS=OFF) the counters stay zero.
+*/
+vector<PhaseStats> getPhaseStats();
+
+/*! \brief Sets the counters of every phase to zero */
+void resetStats();
+
+/*! \brief Returns the phase counters and the peak resident set size as a JSON document:
+\code
+{"enabled": true, "peak_rss_bytes": 13430784, "phases": [
+  {"name": "simplify", "calls": 3, "wall_s": 0.0012, "cpu_s": 0.0011, "terms_in": 120, "terms_out": 80, "blowup": 0.666667},
+  ...]}
+\endcode
+*/
+string stats();
+
+/*!
+  \class PhaseScope
+  \brief Adds the wall and CPU time of its lifetime, one call and the terms in/out to a phase.
+  The counters are atomic, scopes can run in several threads at once.
+  Used through SOSPIN_PHASE and SOSPIN_PHASE_OUT, which compile to nothing without SOSPIN_STATS.
+*/
+class PhaseScope {
+ public:
+  /*! \brief Starts timing phase, which received termsIn terms */
+  PhaseScope(Phase phase, size_t termsIn);
+  /*! \brief Adds the time elapsed since the constructor to the phase */
+  ~PhaseScope();
+  /*! \brief Sets the number of terms returned by the phase */
+  void out(size_t terms) { termsOut = terms; }
+
+ private:
+  PhaseScope(const PhaseScope &);
+  PhaseScope &operator=(const PhaseScope &);
+  Phase phase;
+  size_t termsOut;
+  long long wallStart;
+  long long cpuStart;
+};
+
+/*! \def SOSPIN_PHASE(var, phase, termsIn)
+  \brief Declares the PhaseScope var measuring phase until the end of the enclosing block
+*/
+/*! \def SOSPIN_PHASE_OUT(var, terms)
+  \brief Sets the number of terms returned by the phase measured by var
+*/
+#ifdef SOSPIN_STATS
+#define SOSPIN_PHASE(var, phase, termsIn) PhaseScope var(phase, termsIn)
+#define SOSPIN_PHASE_OUT(var, terms) var.out(terms)
+#else
+#define SOSPIN_PHASE(var, phase, termsIn)
+#define SOSPIN_PHASE_OUT(var, terms)
+#endif
+
+}  // namespace sospin
+
+#endif
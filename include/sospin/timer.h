@@ -29,7 +29,7 @@
 #ifdef WIN32  // Windows system specific
 #include <windows.h>
 #else  // Unix based system specific
-#include <sys/time.h>
+#include <time.h>
 #endif
 
 const std::string currentDateTime();
@@ -71,8 +71,8 @@ class Timer {
   LARGE_INTEGER startCount;  //
   LARGE_INTEGER endCount;    //
 #else
-  timeval startCount;  //
-  timeval endCount;    //
+  timespec startCount;  // CLOCK_MONOTONIC
+  timespec endCount;    //
 #endif
 };
 
@@ -49,6 +49,12 @@
 
 namespace sospin {
 
+/*! \brief Forgets the expressions kept by GammaH and the psi_* constructors.
+    Each constructor builds its expression once per dimension, mode and index head, the following calls
+    return a copy, relabelled if the index table was cleared (CleanGlobalDecl) in the meantime.
+ */
+void clearSO10Templates();
+
 /*!\brief Constructs the ket and bra in the 16th SO(10) representation
 \param mode: bra, ket
        id: defines the head of the index, ex: j1, j2, ...
@@ -0,0 +1,177 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+//       arena.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Memory arena used to allocate the short-lived DList storage created during a Braket evaluation.
+*/
+
+#include <sospin/arena.h>
+
+namespace sospin {
+
+/*! \brief Innermost arena of each thread */
+static thread_local EvalArena* currentArena = 0;
+
+/*!
+  \brief Chunk of memory owned by an arena.
+  "refs" counts the blocks in use plus one reference held by the owner while the arena is open,
+  whoever drops the last reference frees the chunk.
+*/
+struct alignas(16) EvalArena::Chunk {
+  atomic<EvalArena*> owner;
+  atomic<size_t> refs;
+  size_t size;
+};
+
+/*! \brief Header written in front of every block, 16 bytes to keep the payload aligned */
+struct alignas(16) EvalArena::BlockHeader {
+  /*! \brief Chunk holding the block, 0 if the block came from the heap */
+  Chunk* chunk;
+  /*! \brief Size class of the block */
+  size_t cls;
+};
+
+EvalArena::EvalArena(size_t chunkbytes) {
+  previous = currentArena;
+  currentArena = this;
+  for (size_t i = 0; i <= kMaxBlock / kAlign; i++) freelist[i] = 0;
+  cursor = 0;
+  left = 0;
+  chunksize = chunkbytes < 4 * kMaxBlock ? 4 * kMaxBlock : chunkbytes;
+  reserved = 0;
+  inuse = 0;
+  peak = 0;
+  numnodes = 0;
+  numrecycled = 0;
+}
+
+EvalArena::~EvalArena() {
+  currentArena = previous;
+  for (size_t i = 0; i < chunks.size(); i++) {
+    chunks[i]->owner = 0;
+    if (chunks[i]->refs.fetch_sub(1) == 1) {
+      chunks[i]->~Chunk();
+      ::operator delete(chunks[i]);
+    }
+  }
+  chunks.clear();
+}
+
+EvalArena* EvalArena::current() {
+  return currentArena;
+}
+
+void* EvalArena::allocate(size_t bytes) {
+  if (bytes == 0) bytes = 1;
+  size_t size = sizeof(BlockHeader) + ((bytes + kAlign - 1) / kAlign) * kAlign;
+  EvalArena* arena = currentArena;
+  if (arena == 0 || size > kMaxBlock) {
+    BlockHeader* header = static_cast<BlockHeader*>(::operator new(size));
+    header->chunk = 0;
+    header->cls = 0;
+    return header + 1;
+  }
+  return arena->take(size);
+}
+
+void* EvalArena::take(size_t size) {
+  size_t cls = size / kAlign;
+  BlockHeader* header;
+  if (freelist[cls] != 0) {
+    header = static_cast<BlockHeader*>(freelist[cls]);
+    freelist[cls] = *reinterpret_cast<void**>(header + 1);
+    numrecycled++;
+  } else {
+    if (left < size) {
+      void* raw = ::operator new(sizeof(Chunk) + chunksize);
+      Chunk* chunk = new (raw) Chunk;
+      chunk->owner = this;
+      chunk->refs = 1;
+      chunk->size = chunksize;
+      chunks.push_back(chunk);
+      cursor = static_cast<char*>(raw) + sizeof(Chunk);
+      left = chunksize;
+      reserved += sizeof(Chunk) + chunksize;
+    }
+    header = reinterpret_cast<BlockHeader*>(cursor);
+    header->chunk = chunks.back();
+    header->cls = cls;
+    cursor += size;
+    left -= size;
+  }
+  header->chunk->refs++;
+  inuse += size;
+  if (inuse > peak) peak = inuse;
+  numnodes++;
+  return header + 1;
+}
+
+void EvalArena::deallocate(void* ptr) {
+  if (ptr == 0) return;
+  BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+  Chunk* chunk = header->chunk;
+  if (chunk == 0) {
+    ::operator delete(header);
+    return;
+  }
+  // recycle the block only if its arena is still open in this thread
+  EvalArena* owner = chunk->owner;
+  for (EvalArena* arena = currentArena; arena != 0; arena = arena->previous) {
+    if (arena != owner) continue;
+    *reinterpret_cast<void**>(ptr) = arena->freelist[header->cls];
+    arena->freelist[header->cls] = header;
+    arena->inuse -= header->cls * kAlign;
+    chunk->refs--;
+    return;
+  }
+  if (chunk->refs.fetch_sub(1) == 1) {
+    chunk->~Chunk();
+    ::operator delete(chunk);
+  }
+}
+
+void EvalArena::merge(const EvalArena& other) {
+  reserved += other.reserved;
+  numnodes += other.numnodes;
+  numrecycled += other.numrecycled;
+  if (inuse + other.peak > peak) peak = inuse + other.peak;
+}
+
+void EvalArena::report(ostream& out) const {
+  out << "===============================================================" << endl;
+  out << "EvalArena: reserved " << reserved / (1024. * 1024.) << " (MB); in use " << inuse / (1024. * 1024.)
+      << " (MB); peak " << peak / (1024. * 1024.) << " (MB); nodes " << numnodes << " (recycled " << numrecycled << ")" << endl;
+  out << "===============================================================" << endl;
+}
+
+}  // namespace sospin
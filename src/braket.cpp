@@ -42,59 +42,169 @@
   Braket.
 */
 
+#include <sospin/arena.h>
 #include <sospin/braket.h>
 #include <sospin/dlist.h>
+#include <sospin/fock.h>
 #include <sospin/index.h>
 #include <sospin/progressStatus.h>
 #include <sospin/son.h>
+#include <sospin/stats.h>
 #include <sospin/timer.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 namespace sospin {
 
 #define MAX(x, y) (((x) > (y)) ? (x) : (y))
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
 
+/*! \def FORM_WRITER_CHUNK
+  \brief Number of expression terms written to each buffer by Braket::writeForm
+*/
+#ifndef FORM_WRITER_CHUNK
+#define FORM_WRITER_CHUNK 4096
+#endif
+
+/*! \def BRAKET_FILE_VERSION
+  \brief Version of the checkpoint files written by Braket::save.
+
+  Layout, in the byte order of the machine (checked by the marker 0x01020304):
+  - "SOSPINBK", version, marker, sizeof(elemType), dimension, operation, evaluated, flag (uint32 each after the magic);
+  - index table: uint64 count, then each name as uint32 length and bytes;
+  - FORM field declarations and contractions, as the index table;
+  - uint64 number of terms, then per term: int32 index, constant part (as a name), uint32 number of DLists,
+    and per DList: int32 sign, uint32 length and the packed elemType words.
+*/
+#define BRAKET_FILE_VERSION 1
+
+/*! \def LEVI_CIVITA_MAX_NATIVE
+  \brief Largest number of b's contracted by the library after setNativeLeviCivita(),
+  the permutation table has LEVI_CIVITA_MAX_NATIVE! entries. Longer contractions are left to FORM.
+*/
+#ifndef LEVI_CIVITA_MAX_NATIVE
+#define LEVI_CIVITA_MAX_NATIVE 8
+#endif
+
+/*! \def LEVI_CIVITA_MAX_TERMS
+  \brief Largest number of delta products written by the library for one contraction after setNativeLeviCivita().
+  Larger determinants, from many free indices, are shorter as e_(...)*e_(...) and are left to FORM.
+*/
+#ifndef LEVI_CIVITA_MAX_TERMS
+#define LEVI_CIVITA_MAX_TERMS 6
+#endif
+
+/*! \def BOP_BLOCK_SIZE
+  \brief Number of monomials of an implicit B operator (see setImplicitBop()) generated at a time when a product
+  with it is expanded or evaluated. The terms of each block follow the order of the expanded product, so the
+  term order only matches the one of the expanded product while the B operator has up to BOP_BLOCK_SIZE monomials.
+*/
+#ifndef BOP_BLOCK_SIZE
+#define BOP_BLOCK_SIZE 256
+#endif
+
+/*! \brief Work list of the evaluation routines, its nodes are taken from the current EvalArena */
+typedef list<DList, ArenaAllocator<DList> > EvalList;
+
 static bool FlagSimplifyGlobalIndexSum = true;
 
 void setSimplifyIndexSum() { FlagSimplifyGlobalIndexSum = true; }
 
 void unsetSimplifyIndexSum() { FlagSimplifyGlobalIndexSum = false; }
 
-BraketOneTerm::BraketOneTerm() {
-  index = 0;
-  constpart = "";
+static bool FlagLazyProducts = false;
+
+void setLazyProducts() { FlagLazyProducts = true; }
+
+void unsetLazyProducts() { FlagLazyProducts = false; }
+
+static bool FlagCollectTerms = false;
+
+void setCollectTerms() { FlagCollectTerms = true; }
+
+void unsetCollectTerms() { FlagCollectTerms = false; }
+
+static bool FlagNativeLeviCivita = false;
+
+void setNativeLeviCivita() { FlagNativeLeviCivita = true; }
+
+void unsetNativeLeviCivita() { FlagNativeLeviCivita = false; }
+
+bool getNativeLeviCivita() { return FlagNativeLeviCivita; }
+
+static bool FlagFockEvaluation = true;
+
+void setFockEvaluation() { FlagFockEvaluation = true; }
+
+void unsetFockEvaluation() { FlagFockEvaluation = false; }
+
+/*! \brief Memory budget of Braket::evaluateSpilled(), in bytes, 0 evaluates in memory */
+static size_t EvalMemoryBudget = 0;
+/*! \brief Directory of the files written by Braket::evaluateSpilled() */
+static string EvalSpillDir = ".";
+
+void setEvalMemoryBudget(size_t bytes, string dir) {
+  EvalMemoryBudget = bytes;
+  EvalSpillDir = dir;
 }
 
+void unsetEvalMemoryBudget() { EvalMemoryBudget = 0; }
+
+/*!
+  \brief Deferred Braket operation "left op right", see setLazyProducts()
+*/
+struct BraketNode {
+  /*! \brief '*', '+', '-', 'f' for the count terms kept in the file path by Braket::evaluateSpilled(),
+      'B' for the count = 2^N monomials of a product (b_1 - b^dagger_1) ... (b_N - b^dagger_N), see Braket::bProduct(),
+      or 't' for the terms of left shared by several expressions, see Braket::share() */
+  char op;
+  Braket left;
+  Braket right;
+  string path;
+  size_t count;
+  /*! \brief Indices of the factors of a 'B' node */
+  vector<int> ids;
+  /*! \brief Constant part of the terms of a 'B' node */
+  Coefficient coef;
+  /*! \brief Sign of the monomials without b^dagger of a 'B' node */
+  int sign;
+  BraketNode() : op(0), count(0), sign(1) {}
+  ~BraketNode() {
+    if (op == 'f') remove(path.c_str());
+  }
+};
+
+BraketOneTerm::BraketOneTerm() { index = 0; }
+
 BraketOneTerm::BraketOneTerm(const DList& d0) {
   index = 0;
-  constpart = "";
   term.push_back(d0);
 }
 
-BraketOneTerm::BraketOneTerm(int indexin, string constpartin, const DList& d0) {
+// the Coefficient constructor removes the spaces from the constant part written in a string
+BraketOneTerm::BraketOneTerm(int indexin, string constpartin, const DList& d0) : constpart(constpartin) {
   index = indexin;
-  constpartin.erase(std::remove(constpartin.begin(), constpartin.end(), ' '),
-                    constpartin.end());
-  constpart = constpartin;
   term.push_back(d0);
 }
 
-BraketOneTerm::BraketOneTerm(int indexin, string constpartin,
-                             list<DList> termin) {
+BraketOneTerm::BraketOneTerm(int indexin, string constpartin, list<DList> termin) : constpart(constpartin) {
   index = indexin;
-  constpartin.erase(std::remove(constpartin.begin(), constpartin.end(), ' '),
-                    constpartin.end());
-  constpart = constpartin;
   term = termin;
 }
 
-BraketOneTerm::BraketOneTerm(int indexin, string constpartin,
-                             BraketOneTerm& termin) {
+BraketOneTerm::BraketOneTerm(int indexin, string constpartin, BraketOneTerm& termin) : constpart(constpartin) {
   index = indexin;
-  // remove spaces from constant part written in a string
-  constpartin.erase(std::remove(constpartin.begin(), constpartin.end(), ' '),
-                    constpartin.end());
-  constpart = constpartin;
   list<DList>::iterator iter;
   for (iter = termin.term.begin(); iter != termin.term.end(); iter++)
     term.push_back(*iter);
@@ -102,7 +212,7 @@ BraketOneTerm::BraketOneTerm(int indexin, string constpartin,
 
 void BraketOneTerm::expfromForm(string a) {
   index = 0;
-  constpart = a;
+  constpart = Coefficient(a);
 }
 
 void BraketOneTerm::clear() {
@@ -115,7 +225,11 @@ BraketOneTerm::~BraketOneTerm() { clear(); }
 
 list<DList>& BraketOneTerm::GetTerm() { return term; }
 
-string& BraketOneTerm::GetConst() { return constpart; }
+const string BraketOneTerm::GetConst() const { return constpart.str(); }
+
+void BraketOneTerm::SetConst(const string& constpartin) { constpart = Coefficient(constpartin); }
+
+Coefficient& BraketOneTerm::GetCoef() { return constpart; }
 
 int& BraketOneTerm::GetIndex() { return index; }
 
@@ -171,12 +285,14 @@ Braket::Braket(int id, string a, DList d0, OPMode op) {
 Braket::Braket(const Braket& L) {
   flag = L.flag;
   expression = L.expression;
+  lazy = L.lazy;
   operation = L.operation;
   evaluated = L.evaluated;
 }
 
 Braket::Braket(int id, string a, const Braket& L, OPMode op) {
   flag = 0;
+  L.materialize();
   vector<BraketOneTerm>::const_iterator iter;
   for (iter = L.expression.begin(); iter != L.expression.end(); iter++) {
     BraketOneTerm tmp0 = (*iter);
@@ -188,6 +304,7 @@ Braket::Braket(int id, string a, const Braket& L, OPMode op) {
 }
 
 void Braket::expfromForm(vector<string> a) {
+  materialize();
   flag = 0;
   BraketOneTerm tmp;
   for (size_t i = 0; i < a.size(); i++) {
@@ -200,6 +317,7 @@ void Braket::expfromForm(vector<string> a) {
 
 void Braket::clear() {
   expression.clear();
+  lazy.reset();
   operation = none;
   flag = 0;
   evaluated = 0;
@@ -213,10 +331,16 @@ void Braket::setON() { flag = 1; }
 void Braket::setOFF() { flag = 0; }
 
 /*!\brief Return number of terms in current expression*/
-int Braket::size() { return expression.size(); }
+int Braket::size() {
+  if (spilled() || implicitB()) return lazy->count;
+  if (lazy && lazy->op == 't') return lazy->left.expression.size();
+  materialize();
+  return expression.size();
+}
 
 /*!\brief Return expression term at position given by pos*/
 BraketOneTerm& Braket::Get(int pos) {
+  materialize();
   if (pos < 0 || static_cast<unsigned int>(pos) >= expression.size()) {
     cout << "Outside range..." << endl;
     exit(1);
@@ -224,8 +348,23 @@ BraketOneTerm& Braket::Get(int pos) {
   return expression.at(pos);
 }
 
+/*!\brief Return the expression terms from position first to last - 1*/
+Braket Braket::slice(int first, int last) {
+  materialize();
+  if (first < 0 || last < first || static_cast<unsigned int>(last) > expression.size()) {
+    cout << "Outside range..." << endl;
+    exit(1);
+  }
+  Braket tmp;
+  tmp.expression.assign(expression.begin() + first, expression.begin() + last);
+  tmp.operation = operation;
+  tmp.evaluated = evaluated;
+  return tmp;
+}
+
 /* \brief Return/set the index sum of the term given by pos */
 int& Braket::GetIndex(int pos) {
+  materialize();
   if (pos < 0 || static_cast<unsigned int>(pos) >= expression.size()) {
     cout << "Outside range..." << endl;
     exit(1);
@@ -325,6 +464,7 @@ int expevaluationtype(int eval0, int eval1) {
 ////////////////////////////////////////////////////
 Braket Braket::operator=(const Braket& L) {
   expression = L.expression;
+  lazy = L.lazy;
   operation = L.operation;
   evaluated = L.evaluated;
   return *this;
@@ -335,7 +475,7 @@ Braket Braket::operator=(const Braket& L) {
 BraketOneTerm operator-(const BraketOneTerm& L) {
   BraketOneTerm tmp = L;
   if (tmp.term.empty())
-    tmp.constpart = "-1*" + tmp.constpart;
+    tmp.constpart.negate();
   else {
     list<DList>::iterator iter;
     for (iter = tmp.term.begin(); iter != tmp.term.end(); iter++)
@@ -346,7 +486,7 @@ BraketOneTerm operator-(const BraketOneTerm& L) {
 
 void BraketOneTerm::neg() {
   if (term.empty())
-    constpart = "-1*" + constpart;
+    constpart.negate();
   else {
     list<DList>::iterator iter;
     for (iter = term.begin(); iter != term.end(); iter++) (*iter).negate();
@@ -355,6 +495,7 @@ void BraketOneTerm::neg() {
 
 Braket operator-(const Braket& L) {
   Braket tmp = L;
+  tmp.materialize();
   vector<BraketOneTerm>::iterator iter;
   for (iter = tmp.expression.begin(); iter != tmp.expression.end(); iter++)
     (*iter).neg();
@@ -365,12 +506,18 @@ Braket operator-(const Braket& L) {
 ///////////////////////////////////////////////////////////////////////////////////
 // OPERATION: -=
 Braket Braket::operator-=(const Braket& L) {
-  operation = operation - L.operation;
+  OPMode op = operation - L.operation;
   evaluated = expevaluationtype(evaluated, L.evaluated);
-  vector<BraketOneTerm>::const_iterator iter;
-  for (iter = L.expression.begin(); iter != L.expression.end(); iter++) {
-    expression.push_back(-(*iter));
+  if (FlagLazyProducts) {
+    defer('-', L);
+    operation = op;
+    return *this;
   }
+  operation = op;
+  materialize();
+  L.materialize();
+  // by position, L may be this expression (x -= x)
+  for (size_t i = 0, n = L.expression.size(); i < n; i++) expression.push_back(-L.expression[i]);
   rearrange();
   simplify();
   return *this;
@@ -379,8 +526,19 @@ Braket Braket::operator-=(const Braket& L) {
 Braket Braket::operator-(const Braket& L) {
   Braket tmp;
   tmp.operation = operation - L.operation;
-  tmp.expression = expression;
   tmp.evaluated = expevaluationtype(evaluated, L.evaluated);
+  if (FlagLazyProducts) {
+    share();
+    L.share();
+    tmp.lazy = make_shared<BraketNode>();
+    tmp.lazy->op = '-';
+    tmp.lazy->left = *this;
+    tmp.lazy->right = L;
+    return tmp;
+  }
+  materialize();
+  L.materialize();
+  tmp.expression = expression;
 
   vector<BraketOneTerm>::const_iterator iter;
   for (iter = L.expression.begin(); iter != L.expression.end(); iter++)
@@ -394,11 +552,18 @@ Braket Braket::operator-(const Braket& L) {
 ///////////////////////////////////////////////////////////////////////////////////
 // OPERATION: +=
 Braket Braket::operator+=(const Braket& L) {
-  operation = operation + L.operation;
+  OPMode op = operation + L.operation;
   evaluated = expevaluationtype(evaluated, L.evaluated);
-  vector<BraketOneTerm>::const_iterator iter;
-  for (iter = L.expression.begin(); iter != L.expression.end(); iter++)
-    expression.push_back(*iter);
+  if (FlagLazyProducts) {
+    defer('+', L);
+    operation = op;
+    return *this;
+  }
+  operation = op;
+  materialize();
+  L.materialize();
+  // by position, L may be this expression (x += x)
+  for (size_t i = 0, n = L.expression.size(); i < n; i++) expression.push_back(L.expression[i]);
   rearrange();
   simplify();
   return *this;
@@ -407,8 +572,19 @@ Braket Braket::operator+=(const Braket& L) {
 Braket Braket::operator+(const Braket& L) {
   Braket tmp;
   tmp.operation = operation + L.operation;
-  tmp.expression = expression;
   tmp.evaluated = expevaluationtype(evaluated, L.evaluated);
+  if (FlagLazyProducts) {
+    share();
+    L.share();
+    tmp.lazy = make_shared<BraketNode>();
+    tmp.lazy->op = '+';
+    tmp.lazy->left = *this;
+    tmp.lazy->right = L;
+    return tmp;
+  }
+  materialize();
+  L.materialize();
+  tmp.expression = expression;
   vector<BraketOneTerm>::const_iterator iter;
   for (iter = L.expression.begin(); iter != L.expression.end(); iter++)
     tmp.expression.push_back(*iter);
@@ -421,17 +597,17 @@ Braket Braket::operator+(const Braket& L) {
 ///////////////////////////////////////////////////////////////////////////////////
 // OPERATION: *= string
 BraketOneTerm BraketOneTerm::operator*=(const string constval) {
-  if (constpart.empty())
-    constpart = constval;
-  else
-    constpart += "*" + constval;
+  constpart *= Coefficient(constval);
   return *this;
 }
 
 Braket Braket::operator*=(const string constval) {
+  materialize();
+  // the constant is read once and shared by every term
+  Coefficient c(constval);
   vector<BraketOneTerm>::iterator iter;
   for (iter = expression.begin(); iter != expression.end(); iter++)
-    *iter *= constval;
+    iter->GetCoef() *= c;
   return *this;
 }
 
@@ -442,21 +618,20 @@ BraketOneTerm BraketOneTerm::operator*(const string constval) {
   BraketOneTerm tmp;
   tmp.index = index;
   tmp.term = term;
-  if (constpart.empty())
-    tmp.constpart = constval;
-  else
-    tmp.constpart = constpart + "*" + constval;
+  tmp.constpart = constpart * Coefficient(constval);
   return tmp;
 }
 
 Braket Braket::operator*(const string constval) {
+  materialize();
   Braket tmp;
   tmp.operation = operation;
   tmp.expression = expression;
   tmp.evaluated = evaluated;
+  Coefficient c(constval);
   vector<BraketOneTerm>::iterator iter;
   for (iter = tmp.expression.begin(); iter != tmp.expression.end(); iter++)
-    *iter *= constval;
+    iter->GetCoef() *= c;
 
   return tmp;
 }
@@ -464,20 +639,15 @@ Braket Braket::operator*(const string constval) {
 ///////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////
 // OPERATION: *
-BraketOneTerm BraketOneTerm::operator*(const BraketOneTerm& L) {
+BraketOneTerm BraketOneTerm::operator*(const BraketOneTerm& L) const {
   if ((term.empty() && constpart.empty())) return *this;
   if ((L.term.empty() && L.constpart.empty())) return L;
 
   BraketOneTerm tmp;
   tmp.index = index + L.index;
-  if (constpart.empty())
-    tmp.constpart = L.constpart;
-  else if (L.constpart.empty())
-    tmp.constpart = constpart;
-  else
-    tmp.constpart = constpart + "*" + L.constpart;
+  tmp.constpart = constpart * L.constpart;
 
-  list<DList>::iterator iter;
+  list<DList>::const_iterator iter;
   list<DList>::const_iterator liter;
   if (term.empty()) {
     for (liter = L.term.begin(); liter != L.term.end(); liter++)
@@ -494,6 +664,182 @@ BraketOneTerm BraketOneTerm::operator*(const BraketOneTerm& L) {
   return tmp;
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+// OPERATION: collect()
+bool BraketOneTerm::canonicalize() {
+  if (term.empty()) return false;
+  vector<pair<unsigned long long, DList> > dl;
+  dl.reserve(term.size());
+  for (list<DList>::iterator iter = term.begin(); iter != term.end(); iter++) {
+    DList c = (*iter).canonical();
+    dl.push_back(make_pair(c.hash(), std::move(c)));
+  }
+  stable_sort(dl.begin(), dl.end(),
+              [](const pair<unsigned long long, DList>& a, const pair<unsigned long long, DList>& b) { return a.first < b.first; });
+  // add up the signs of equal DLists
+  term.clear();
+  vector<char> done(dl.size(), 0);
+  for (size_t i = 0; i < dl.size(); i++) {
+    if (done[i]) continue;
+    int net = 0;
+    for (size_t j = i; j < dl.size() && dl[j].first == dl[i].first; j++)
+      if (!done[j] && dl[j].second.sameElements(dl[i].second)) {
+        net += dl[j].second.getSign();
+        done[j] = 1;
+      }
+    DList& c = dl[i].second;
+    c.set_sign(net < 0 ? -1 : 1);
+    for (int k = 0; k < abs(net); k++) term.push_back(c);
+  }
+  if (term.empty()) {
+    clear();
+    return true;
+  }
+  return false;
+}
+
+unsigned long long BraketOneTerm::hash() const {
+  unsigned long long h = 14695981039346656037ULL ^ (unsigned int)index;
+  int sign0 = term.empty() ? 1 : term.front().getSign();
+  for (list<DList>::const_iterator iter = term.begin(); iter != term.end(); iter++) {
+    h = (h ^ (*iter).hash()) * 1099511628211ULL;
+    h = (h ^ (unsigned int)((*iter).getSign() * sign0 + 1)) * 1099511628211ULL;
+  }
+  return h;
+}
+
+int BraketOneTerm::like(const BraketOneTerm& L) const {
+  if (index != L.index || term.size() != L.term.size() || term.empty()) return 0;
+  int s = term.front().getSign() * L.term.front().getSign();
+  list<DList>::const_iterator liter = L.term.begin();
+  for (list<DList>::const_iterator iter = term.begin(); iter != term.end(); iter++, liter++)
+    if ((*iter).getSign() != s * (*liter).getSign() || !(*iter).sameElements(*liter)) return 0;
+  return s;
+}
+
+void Braket::collect() {
+  materialize();
+  if (getVerbosity() >= VERBOSE) cout << "Collecting like terms..." << endl;
+  int total = expression.size();
+  Progress progress("Progress: ", total);
+  // position in the new expression of the terms with each hash
+  unordered_map<unsigned long long, vector<size_t> > groups;
+  // merged coefficients, empty while a term was not merged
+  vector<vector<Coefficient> > coef;
+  vector<vector<int> > signs;
+  size_t kept = 0;
+  for (size_t i = 0; i < expression.size(); i++) {
+    BraketOneTerm& term = expression[i];
+    progress.set(i + 1);
+    if (term.GetTerm().empty()) {
+      if (kept != i) expression[kept] = std::move(term);
+      coef.push_back(vector<Coefficient>());
+      signs.push_back(vector<int>());
+      kept++;
+      continue;
+    }
+    if (term.canonicalize()) continue;
+    vector<size_t>& pos = groups[term.hash()];
+    bool merged = false;
+    for (size_t k = 0; k < pos.size() && !merged; k++) {
+      size_t p = pos[k];
+      int s = expression[p].like(term);
+      if (s == 0) continue;
+      if (coef[p].empty()) {
+        coef[p].push_back(expression[p].GetCoef());
+        signs[p].push_back(1);
+      }
+      coef[p].push_back(term.GetCoef());
+      signs[p].push_back(s);
+      merged = true;
+    }
+    if (merged) continue;
+    pos.push_back(kept);
+    if (kept != i) expression[kept] = std::move(term);
+    coef.push_back(vector<Coefficient>());
+    signs.push_back(vector<int>());
+    kept++;
+  }
+  expression.erase(expression.begin() + kept, expression.end());
+  for (size_t i = 0; i < expression.size(); i++)
+    if (!coef[i].empty()) expression[i].GetCoef() = Coefficient::sum(coef[i], signs[i]);
+}
+
+void BraketOneTerm::summary(vector<MonomialInfo>& out) const {
+  for (list<DList>::const_iterator iter = term.begin(); iter != term.end(); iter++) out.push_back((*iter).info());
+}
+
+/*! \brief Returns true if the product of two DLists with summaries "l" and "r" is removed by BraketOneTerm::Simplify(oper) */
+static inline bool ZeroProduct(const MonomialInfo& l, const MonomialInfo& r, OPMode oper) {
+  if (!l.deltas || !r.deltas) return true;
+  // first and last b/b^dagger of the product
+  int first = l.first >= 0 ? l.first : r.first;
+  int last = r.last >= 0 ? r.last : l.last;
+  switch (oper) {
+    case none:
+      return false;
+    case bra:
+      return first == 1;
+    case ket:
+      return last == 0;
+    case braket:
+      return l.nb + r.nb != l.nbt + r.nbt || first == 1 || last == 0;
+  }
+  return false;
+}
+
+bool BraketOneTerm::multiply(const BraketOneTerm& L, const vector<MonomialInfo>& info, const vector<MonomialInfo>& linfo,
+                             OPMode oper, bool checkidx, BraketOneTerm& out) const {
+  if ((term.empty() && constpart.empty()) || (L.term.empty() && L.constpart.empty())) {
+    out = (*this) * L;
+    return true;
+  }
+  if (checkidx) {
+    int idx = index + L.index;
+    if (idx != 0 && abs(idx) != getDim() / 2) return false;
+  }
+  if (term.empty() || L.term.empty() || info.empty() || linfo.empty()) {
+    out = (*this) * L;
+    return true;
+  }
+  // every DList pair of the product would be removed
+  bool any = false;
+  for (size_t i = 0; i < info.size() && !any; i++)
+    for (size_t j = 0; j < linfo.size() && !any; j++)
+      if (!ZeroProduct(info[i], linfo[j], oper)) any = true;
+  if (!any) return false;
+
+  out.clear();
+  out.index = index + L.index;
+  out.constpart = constpart * L.constpart;
+  size_t i = 0;
+  for (list<DList>::const_iterator iter = term.begin(); iter != term.end(); iter++, i++) {
+    size_t j = 0;
+    for (list<DList>::const_iterator liter = L.term.begin(); liter != L.term.end(); liter++, j++)
+      if (!ZeroProduct(info[i], linfo[j], oper)) out.term.push_back((*iter) * (*liter));
+  }
+  return true;
+}
+
+void Braket::multiplyTerms(const vector<BraketOneTerm>& lterms, const vector<BraketOneTerm>& rterms,
+                           vector<BraketOneTerm>& out) const {
+  // DList pairs are only pruned when simplify() would look at them, terms whose index sum
+  // is rejected by checkindex() are never built
+  bool prune = evaluated != 2;
+  bool checkidx = FlagSimplifyGlobalIndexSum && operation == braket;
+  vector<vector<MonomialInfo> > linfo(lterms.size()), rinfo(rterms.size());
+  if (prune) {
+    for (size_t i = 0; i < lterms.size(); i++) lterms[i].summary(linfo[i]);
+    for (size_t j = 0; j < rterms.size(); j++) rterms[j].summary(rinfo[j]);
+  }
+  for (size_t i = 0; i < lterms.size(); i++)
+    for (size_t j = 0; j < rterms.size(); j++) {
+      BraketOneTerm term;
+      if (lterms[i].multiply(rterms[j], linfo[i], rinfo[j], operation, checkidx, term)) out.push_back(std::move(term));
+    }
+}
+
 Braket Braket::operator*(const Braket& L) {
   Braket tmp;
   if (operation == braket && L.operation == braket) {
@@ -510,11 +856,18 @@ Braket Braket::operator*(const Braket& L) {
   }
   tmp.evaluated = expevaluationtype(evaluated, L.evaluated);
   tmp.operation = operation * L.operation;
-  vector<BraketOneTerm>::iterator iter;
-  vector<BraketOneTerm>::const_iterator liter;
-  for (iter = expression.begin(); iter != expression.end(); iter++)
-    for (liter = L.expression.begin(); liter != L.expression.end(); liter++)
-      tmp.expression.push_back((*iter) * (*liter));
+  if (FlagLazyProducts || implicitBop() || L.implicitBop()) {
+    share();
+    L.share();
+    tmp.lazy = make_shared<BraketNode>();
+    tmp.lazy->op = '*';
+    tmp.lazy->left = *this;
+    tmp.lazy->right = L;
+    return tmp;
+  }
+  materialize();
+  L.materialize();
+  tmp.multiplyTerms(expression, L.expression, tmp.expression);
   tmp.rearrange();
   tmp.simplify();
   return tmp;
@@ -537,13 +890,17 @@ Braket& Braket::operator*=(const Braket& L) {
     }
   }
   evaluated = expevaluationtype(evaluated, L.evaluated);
-  operation = operation * L.operation;
-  vector<BraketOneTerm>::iterator iter;
-  vector<BraketOneTerm>::const_iterator liter;
+  OPMode op = operation * L.operation;
+  if (FlagLazyProducts || implicitBop() || L.implicitBop()) {
+    defer('*', L);
+    operation = op;
+    return *this;
+  }
+  operation = op;
+  materialize();
+  L.materialize();
   vector<BraketOneTerm> tmp;
-  for (iter = expression.begin(); iter != expression.end(); iter++)
-    for (liter = L.expression.begin(); liter != L.expression.end(); liter++)
-      tmp.push_back((*iter) * (*liter));
+  multiplyTerms(expression, L.expression, tmp);
   expression.clear();
   expression = tmp;
   tmp.clear();
@@ -552,63 +909,275 @@ Braket& Braket::operator*=(const Braket& L) {
   return *this;
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+// TERM STORAGE, used by the checkpoints and the out-of-core evaluation
+/*! \brief Magic string at the beginning of the checkpoint files */
+static const char BraketFileMagic[8] = {'S', 'O', 'S', 'P', 'I', 'N', 'B', 'K'};
+
+template <class T>
+static inline void PutRaw(ostream& out, T v) {
+  out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+static inline void PutString(ostream& out, const string& v) {
+  PutRaw<uint32_t>(out, v.size());
+  out.write(v.data(), v.size());
+}
+
+static void PutStrings(ostream& out, const vector<string>& v) {
+  PutRaw<uint64_t>(out, v.size());
+  for (size_t i = 0; i < v.size(); i++) PutString(out, v[i]);
+}
+
+/*! \brief Writes one term: index, constant part, number of DLists and, per DList, sign, length and elemType words */
+static void PutTerm(ostream& out, BraketOneTerm& term) {
+  PutRaw<int32_t>(out, term.GetIndex());
+  PutString(out, term.GetConst());
+  PutRaw<uint32_t>(out, term.GetTerm().size());
+  for (list<DList>::const_iterator iter = term.GetTerm().begin(); iter != term.GetTerm().end(); iter++) {
+    PutRaw<int32_t>(out, iter->getSign());
+    PutRaw<uint32_t>(out, iter->size());
+    for (unsigned int k = 0; k < iter->size(); k++) PutRaw(out, iter->at(k).dataField);
+  }
+}
+
+/*! \brief Reads the checkpoint mapped in memory, every read checks the bounds */
+class BraketFileReader {
+  const char* cur;
+  const char* end;
+
+ public:
+  bool ok;
+  BraketFileReader(const char* begin, const char* last) : cur(begin), end(last), ok(true) {}
+  template <class T>
+  T get() {
+    T v = T();
+    if (!ok || (size_t)(end - cur) < sizeof(T)) {
+      ok = false;
+      return v;
+    }
+    memcpy(&v, cur, sizeof(T));
+    cur += sizeof(T);
+    return v;
+  }
+  bool bytes(void* out, size_t n) {
+    if (!ok || (size_t)(end - cur) < n) return ok = false;
+    memcpy(out, cur, n);
+    cur += n;
+    return true;
+  }
+  string str() {
+    uint32_t n = get<uint32_t>();
+    if (!ok || (size_t)(end - cur) < n) {
+      ok = false;
+      return string();
+    }
+    string v(cur, n);
+    cur += n;
+    return v;
+  }
+  vector<string> strs() {
+    uint64_t n = get<uint64_t>();
+    vector<string> v;
+    for (uint64_t i = 0; i < n && ok; i++) v.push_back(str());
+    return v;
+  }
+};
+
+/*! \brief Reads the terms spilled to a file by Braket::evaluateSpilled(), with the interface of BraketFileReader */
+class BraketStreamReader {
+  istream& in;
+
+ public:
+  bool ok;
+  BraketStreamReader(istream& input) : in(input), ok(true) {}
+  template <class T>
+  T get() {
+    T v = T();
+    if (ok && !in.read(reinterpret_cast<char*>(&v), sizeof(T))) ok = false;
+    return v;
+  }
+  string str() {
+    uint32_t n = get<uint32_t>();
+    string v;
+    if (!ok) return v;
+    v.resize(n);
+    if (n > 0 && !in.read(&v[0], n)) ok = false;
+    return v;
+  }
+};
+
+/*! \brief Reads one term written by PutTerm
+    \param[in,out] in BraketFileReader or BraketStreamReader, in.ok is false if the data ends before the term
+    \param[out] term term read
+    \param[in] remap new positions of the saved indices in the index table, NULL to keep them
+*/
+template <class Reader>
+static void GetTerm(Reader& in, BraketOneTerm& term, const vector<int>* remap) {
+  term.GetIndex() = in.template get<int32_t>();
+  term.SetConst(in.str());
+  uint32_t ndlists = in.template get<uint32_t>();
+  for (uint32_t j = 0; j < ndlists && in.ok; j++) {
+    DList d;
+    int sign = in.template get<int32_t>();
+    uint32_t length = in.template get<uint32_t>();
+    for (uint32_t k = 0; k < length && in.ok; k++) {
+      elemType elem;
+      elem.dataField = in.template get<decltype(elem.dataField)>();
+      unsigned int type = elem.getType();
+      if (remap && type <= 2) {
+        if (elem.getIdx1() < remap->size()) elem.setIdx1((*remap)[elem.getIdx1()]);
+        if (type == 2 && elem.getIdx2() < remap->size()) elem.setIdx2((*remap)[elem.getIdx2()]);
+      }
+      d << elem;
+    }
+    d.set_sign(sign);
+    term.GetTerm().push_back(d);
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////
 // STREAM OPERATORS
-ostream& operator<<(ostream& out, const BraketOneTerm& L) {
-  if (L.term.empty())
-    out << L.constpart;
+/*! \brief Appends the decimal representation of n to out */
+static inline void AppendInt(string& out, long n) {
+  char buf[24];
+  int len = 0;
+  unsigned long v = n < 0 ? 0UL - (unsigned long)n : (unsigned long)n;
+  do {
+    buf[len++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  if (n < 0) out += '-';
+  while (len) out += buf[--len];
+}
+
+void BraketOneTerm::appendTo(string& out) const {
+  if (term.empty()) {
+    constpart.appendTo(out);
+    return;
+  }
+  if (constpart.empty())
+    out += "(\n";
   else {
-    if (L.constpart.empty())
-      out << "(" << endl;
-    else
-      out << "(" << L.constpart << ")"
-          << " * (" << endl;
-    list<DList>::const_iterator iter;
-    for (iter = L.term.begin(); iter != L.term.end(); iter++) {
-      out << "\t";
-      DList tmp = (*iter);
-      tmp.set_begin();
-      if (tmp.getSign() == -1) out << " - ";
-      if (tmp.getSign() == 1) out << " + ";
-      if (tmp.isEmpty())
-        out << " 0 ";
-      else
-        while (true) {
-          elemType elem = tmp.get();
-          if (elem.getType() == 2)
-            out << "d_(" << getIdx(elem.getIdx1()) << ","
-                << getIdx(elem.getIdx2()) << ")";
-          if (elem.getType() == 0) out << "b(" << getIdx(elem.getIdx1()) << ")";
-          if (elem.getType() == 1)
-            out << "bt(" << getIdx(elem.getIdx1()) << ")";
-          if (elem.getType() == 3) out << "1";
-          if (tmp.isActualLast())
-            break;
-          else
-            out << " * ";
-          tmp.shift_right();
+    out += '(';
+    constpart.appendTo(out);
+    out += ") * (\n";
+  }
+  for (list<DList>::const_iterator iter = term.begin(); iter != term.end(); iter++) {
+    const DList& dl = *iter;
+    out += '\t';
+    if (dl.getSign() == -1) out += " - ";
+    if (dl.getSign() == 1) out += " + ";
+    unsigned int n = dl.size();
+    if (n == 0) out += " 0 ";
+    for (unsigned int k = 0; k < n; k++) {
+      const elemType& elem = dl.at(k);
+      switch (elem.getType()) {
+        case 2:
+          out += "d_(";
+          out += getIdx(elem.getIdx1());
+          out += ',';
+          out += getIdx(elem.getIdx2());
+          out += ')';
+          break;
+        case 0:
+          out += "b(";
+          out += getIdx(elem.getIdx1());
+          out += ')';
+          break;
+        case 1:
+          out += "bt(";
+          out += getIdx(elem.getIdx1());
+          out += ')';
+          break;
+        case 3:
+          out += '1';
+          break;
+      }
+      if (k + 1 < n) out += " * ";
+    }
+    out += '\n';
+  }
+  out += ')';
+}
+
+ostream& operator<<(ostream& out, const BraketOneTerm& L) {
+  string buf;
+  L.appendTo(buf);
+  return out.write(buf.data(), buf.size());
+}
+
+/*! \brief Writes the terms, numbering them "Local R? = " from first + 1 if numbered is true.
+    The terms are formatted by getThreads() threads, in chunks of FORM_WRITER_CHUNK terms written in order.
+*/
+static void WriteTerms(ostream& out, const vector<BraketOneTerm>& terms, size_t first, bool numbered) {
+  size_t total = terms.size();
+  size_t nchunks = (total + FORM_WRITER_CHUNK - 1) / FORM_WRITER_CHUNK;
+  size_t nthreads = getThreads();
+  if (nthreads > nchunks) nthreads = nchunks;
+  if (nthreads < 1) nthreads = 1;
+  vector<string> buf(nthreads);
+  // the chunks are written in rounds of nthreads buffers, filled in parallel and written in order
+  for (size_t round = 0; round < nchunks; round += nthreads) {
+    auto fill = [&](size_t t) {
+      string& b = buf[t];
+      b.clear();
+      size_t begin = (round + t) * FORM_WRITER_CHUNK;
+      size_t end = MIN(begin + FORM_WRITER_CHUNK, total);
+      for (size_t i = begin; i < end; i++) {
+        if (numbered) {
+          b += "Local R";
+          AppendInt(b, first + i + 1);
+          b += " = ";
         }
-      out << endl;
+        terms[i].appendTo(b);
+        b += ";\n";
+      }
+    };
+    size_t n = MIN(nthreads, nchunks - round);
+    if (n == 1)
+      fill(0);
+    else {
+      vector<thread> workers;
+      for (size_t t = 0; t < n; t++) workers.push_back(thread(fill, t));
+      for (size_t t = 0; t < n; t++) workers[t].join();
     }
-    out << ")";
+    for (size_t t = 0; t < n; t++) out.write(buf[t].data(), buf[t].size());
   }
-  return out;
 }
 
-ostream& operator<<(ostream& out, const Braket& L) {
-  int R = 0;
-  // static int R=0;
-  if (L.expression.size() == 0)
-    out << "Local R" << ++R << " = 0;";
-  else
-    for (size_t i = 0; i < L.expression.size(); i++) {
-      if (L.flag) out << "Local R" << ++R << " = ";
-      if (L.expression.empty())
-        out << "0;" << endl;
-      else
-        out << L.expression.at(i) << ";" << endl;
+void Braket::writeTerms(ostream& out, bool numbered) const {
+  if (spilled() && lazy->count > 0) {
+    // the terms are read back from the spill file one batch at a time
+    ifstream in(lazy->path.c_str(), ios::binary);
+    BraketStreamReader reader(in);
+    size_t batch = (size_t)FORM_WRITER_CHUNK * getThreads();
+    vector<BraketOneTerm> terms;
+    for (size_t first = 0; first < lazy->count && reader.ok; first += terms.size()) {
+      terms.assign(MIN(batch, lazy->count - first), BraketOneTerm());
+      for (size_t i = 0; i < terms.size(); i++) GetTerm(reader, terms[i], NULL);
+      WriteTerms(out, terms, first, numbered);
     }
+    if (!reader.ok) {
+      cout << "Error reading " << lazy->path << endl;
+      exit(1);
+    }
+    return;
+  }
+  materialize();
+  if (expression.empty()) {
+    out << "Local R1 = 0;";
+    return;
+  }
+  WriteTerms(out, expression, 0, numbered);
+}
+
+void Braket::writeForm(ostream& out) const { writeTerms(out, true); }
+
+ostream& operator<<(ostream& out, const Braket& L) {
+  L.writeTerms(out, L.flag != 0);
   return out;
 }
 
@@ -621,6 +1190,111 @@ string& operator<<(string& out, const Braket& L) {
 
 string& operator+(string& out, const Braket& L) { return out << L; }
 
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+// CHECKPOINTS
+bool Braket::save(const string& path) const {
+  materialize();
+  vector<char> filebuf(1 << 20);
+  ofstream out;
+  out.rdbuf()->pubsetbuf(filebuf.data(), filebuf.size());
+  out.open(path.c_str(), ios::binary | ios::trunc);
+  if (!out.is_open()) {
+    cout << "Cannot create checkpoint file: " << path << endl;
+    return false;
+  }
+  out.write(BraketFileMagic, sizeof(BraketFileMagic));
+  PutRaw<uint32_t>(out, BRAKET_FILE_VERSION);
+  PutRaw<uint32_t>(out, 0x01020304);
+  PutRaw<uint32_t>(out, sizeof(elemType));
+  PutRaw<uint32_t>(out, getDim());
+  PutRaw<uint32_t>(out, operation);
+  PutRaw<uint32_t>(out, evaluated);
+  PutRaw<uint32_t>(out, flag);
+  PutStrings(out, tabids);
+  PutStrings(out, form.getFunctionList());
+  PutStrings(out, form.getFCList());
+  // the terms are written one by one, without a second copy of the expression
+  PutRaw<uint64_t>(out, expression.size());
+  for (size_t i = 0; i < expression.size(); i++) PutTerm(out, expression[i]);
+  out.close();
+  if (out.fail()) {
+    cout << "Error writing checkpoint file: " << path << endl;
+    return false;
+  }
+  return true;
+}
+
+bool Braket::load(const string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) close(fd);
+    cout << "Cannot read checkpoint file: " << path << endl;
+    return false;
+  }
+  void* map = MAP_FAILED;
+  if (st.st_size > 0) map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    cout << "Cannot read checkpoint file: " << path << endl;
+    return false;
+  }
+  madvise(map, st.st_size, MADV_SEQUENTIAL);
+  const char* data = static_cast<const char*>(map);
+  BraketFileReader in(data, data + st.st_size);
+  char magic[sizeof(BraketFileMagic)];
+  string error;
+  if (!in.bytes(magic, sizeof(magic)) || memcmp(magic, BraketFileMagic, sizeof(magic)) != 0)
+    error = "not a Braket checkpoint";
+  else if (in.get<uint32_t>() != BRAKET_FILE_VERSION)
+    error = "unknown version";
+  else if (in.get<uint32_t>() != 0x01020304)
+    error = "saved with another byte order";
+  else if (in.get<uint32_t>() != sizeof(elemType))
+    error = "saved with another elemType layout (SOSPIN_WIDE_ELEM)";
+  else if ((int)in.get<uint32_t>() != getDim())
+    error = "saved for another dimension";
+  if (!error.empty()) {
+    munmap(map, st.st_size);
+    cout << "Cannot load " << path << ": " << error << endl;
+    return false;
+  }
+  OPMode op = (OPMode)in.get<uint32_t>();
+  unsigned int ev = in.get<uint32_t>();
+  int fl = in.get<uint32_t>();
+  // the saved indices get their positions in the current index table
+  vector<string> ids = in.strs();
+  vector<int> remap(ids.size());
+  bool renumber = false;
+  for (size_t i = 0; i < ids.size(); i++) {
+    remap[i] = newIdx(ids[i]);
+    if (remap[i] != (int)i) renumber = true;
+  }
+  vector<string> functions = in.strs();
+  vector<string> contractions = in.strs();
+  for (size_t i = 0; i < functions.size(); i++) form << functions[i];
+  for (size_t i = 0; i < contractions.size(); i++) form + contractions[i];
+  uint64_t nterms = in.get<uint64_t>();
+  vector<BraketOneTerm> terms;
+  terms.reserve(in.ok ? MIN(nterms, (uint64_t)st.st_size) : 0);
+  for (uint64_t i = 0; i < nterms && in.ok; i++) {
+    terms.push_back(BraketOneTerm());
+    GetTerm(in, terms.back(), renumber ? &remap : NULL);
+  }
+  munmap(map, st.st_size);
+  if (!in.ok) {
+    cout << "Cannot load " << path << ": truncated file" << endl;
+    return false;
+  }
+  lazy.reset();
+  expression.swap(terms);
+  operation = op;
+  evaluated = ev;
+  flag = fl;
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////
 // OPERATION: rearrange()
@@ -631,16 +1305,19 @@ void BraketOneTerm::rearrange() {
 }
 
 void Braket::rearrange() {
+  materialize();
   if (evaluated == 2) return;
   if (getVerbosity() >= VERBOSE) cout << "Ordering..." << endl;
   int total = expression.size();
+  SOSPIN_PHASE(phase, PHASE_REARRANGE, total);
+  SOSPIN_PHASE_OUT(phase, total);
   int i = 0;
-  DoProgress("Progress: ", 0, total);
+  Progress progress("Progress: ", total);
   vector<BraketOneTerm>::iterator iter;
   for (iter = expression.begin(); iter != expression.end(); iter++) {
     (*iter).rearrange();
     i++;
-    DoProgress("Progress: ", i, total);
+    progress.set(i);
   }
 }
 
@@ -655,21 +1332,23 @@ bool BraketOneTerm::checkindex() {
 }
 
 void Braket::checkindex() {
+  materialize();
   if (FlagSimplifyGlobalIndexSum) {
     if (operation == braket) {
       if (getVerbosity() >= VERBOSE) cout << "Checking Indices..." << endl;
       int total = expression.size();
-      DoProgress("Progress: ", 0, total);
-      vector<BraketOneTerm> tmp;
+      SOSPIN_PHASE(phase, PHASE_CHECKINDEX, total);
+      Progress progress("Progress: ", total);
+      size_t kept = 0;
       for (size_t i = 0; i < expression.size(); i++) {
         if (expression.at(i).checkindex()) {
-          tmp.push_back(expression.at(i));
-          expression.at(i).clear();
+          if (kept != i) expression[kept] = std::move(expression[i]);
+          kept++;
         }
-        DoProgress("Progress: ", i + 1, total);
+        progress.set(i + 1);
       }
-      expression.clear();
-      expression = tmp;
+      expression.erase(expression.begin() + kept, expression.end());
+      SOSPIN_PHASE_OUT(phase, kept);
     }
   }
 }
@@ -678,13 +1357,14 @@ void Braket::checkindex() {
 ///////////////////////////////////////////////////////////////////////////////////
 // OPERATION: gindexsetnull()
 void Braket::gindexsetnull() {
+  materialize();
   if (getVerbosity() >= VERBOSE)
     cout << "Setting global indice terms to zero..." << endl;
   int total = expression.size();
-  DoProgress("Progress: ", 0, total);
+  Progress progress("Progress: ", total);
   for (size_t i = 0; i < expression.size(); i++) {
     expression.at(i).GetIndex() = 0;
-    DoProgress("Progress: ", i + 1, total);
+    progress.set(i + 1);
   }
 }
 
@@ -729,24 +1409,212 @@ bool BraketOneTerm::Simplify(OPMode operation) {
 }
 
 void Braket::simplify() {
+  materialize();
+  SOSPIN_PHASE(phase, PHASE_SIMPLIFY, expression.size());
   checkindex();
   if (evaluated != 2) {
     if (getVerbosity() >= VERBOSE) cout << "Simplifying expression..." << endl;
     int total = expression.size();
     size_t i = 0;
-    DoProgress("Progress: ", i, total);
-    vector<BraketOneTerm> tmp;
+    Progress progress("Progress: ", total);
+    // simplify each term in place and compact the surviving ones
+    size_t kept = 0;
     for (i = 0; i < expression.size(); i++) {
-      BraketOneTerm tmp0;
-      tmp0 = expression.at(i);
-      if (!tmp0.Simplify(operation)) tmp.push_back(tmp0);
-      DoProgress("Progress: ", i + 1, total);
+      if (!expression[i].Simplify(operation)) {
+        if (kept != i) expression[kept] = std::move(expression[i]);
+        kept++;
+      }
+      progress.set(i + 1);
+    }
+    expression.erase(expression.begin() + kept, expression.end());
+  }
+  SOSPIN_PHASE_OUT(phase, expression.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+// Deferred operations, see setLazyProducts()
+bool Braket::implicitB() const { return lazy && lazy->op == 'B'; }
+
+const Braket* Braket::implicitBop() const {
+  if (!lazy) return NULL;
+  if (lazy->op == 'B') return this;
+  if (lazy->op != '*') return NULL;
+  const Braket* bop = lazy->left.implicitBop();
+  return bop ? bop : lazy->right.implicitBop();
+}
+
+/*! \brief Appends the monomials first to last - 1 of the 'B' node to out.
+    Monomial m has b^dagger_k for the factor k whose bit N-k of m is set, and the sign (-1)^popcount(m),
+    which is the order and the signs of the expanded product (b_1 - b^dagger_1) ... (b_N - b^dagger_N).
+*/
+static void BProductTerms(const BraketNode& node, size_t first, size_t last, vector<BraketOneTerm>& out) {
+  size_t n = node.ids.size();
+  out.reserve(out.size() + last - first);
+  for (size_t m = first; m < last; m++) {
+    DList d;
+    int sign = node.sign;
+    for (size_t k = 0; k < n; k++) {
+      int dagger = (m >> (n - 1 - k)) & 1;
+      d << elemType::make_elem(dagger, node.ids[k]);
+      if (dagger) sign = -sign;
+    }
+    d.set_sign(sign);
+    out.push_back(BraketOneTerm(d));
+    out.back().GetCoef() *= node.coef;
+  }
+}
+
+Braket Braket::bProduct(const vector<int>& ids, const string& constval, bool negate, bool implicit) {
+  shared_ptr<BraketNode> node = make_shared<BraketNode>();
+  node->op = 'B';
+  node->ids = ids;
+  node->coef = Coefficient(constval);
+  node->sign = negate ? -1 : 1;
+  node->count = size_t(1) << ids.size();
+  Braket tmp;
+  if (implicit)
+    tmp.lazy = node;
+  else
+    BProductTerms(*node, 0, node->count, tmp.expression);
+  return tmp;
+}
+
+void Braket::defer(char op, const Braket& L) {
+  shared_ptr<BraketNode> node = make_shared<BraketNode>();
+  node->op = op;
+  // copied first, L may be this expression (x += x)
+  L.share();
+  node->right = L;
+  node->left.expression.swap(expression);
+  node->left.lazy = lazy;
+  node->left.operation = operation;
+  node->left.evaluated = evaluated;
+  lazy = node;
+}
+
+bool Braket::keepTerm(BraketOneTerm& term) const {
+  // same rules as rearrange() followed by simplify(), applied to a single term
+  if (evaluated != 2) term.rearrange();
+  if (FlagSimplifyGlobalIndexSum && operation == braket && !term.checkindex()) return false;
+  if (evaluated == 2) return true;
+  return !term.Simplify(operation);
+}
+
+void Braket::expandTerms(vector<BraketOneTerm>& out, const Braket* bop, size_t block) const {
+  if (!lazy) {
+    out.insert(out.end(), expression.begin(), expression.end());
+    return;
+  }
+  const BraketNode& node = *lazy;
+  if (node.op == 't') {
+    out.insert(out.end(), node.left.expression.begin(), node.left.expression.end());
+    return;
+  }
+  if (node.op == 'f') {
+    ifstream in(node.path.c_str(), ios::binary);
+    BraketStreamReader reader(in);
+    out.reserve(out.size() + node.count);
+    for (size_t i = 0; i < node.count && reader.ok; i++) {
+      out.push_back(BraketOneTerm());
+      GetTerm(reader, out.back(), NULL);
+    }
+    if (!reader.ok) {
+      cout << "Error reading " << node.path << endl;
+      exit(1);
+    }
+    return;
+  }
+  if (node.op == 'B') {
+    if (this == bop)
+      BProductTerms(node, block * BOP_BLOCK_SIZE, min(node.count, (block + 1) * BOP_BLOCK_SIZE), out);
+    else
+      BProductTerms(node, 0, node.count, out);
+    return;
+  }
+  if (node.op == '*') {
+    // operands that are not deferred are used in place
+    vector<BraketOneTerm> ltmp, rtmp;
+    const vector<BraketOneTerm>* lterms = &node.left.expression;
+    const vector<BraketOneTerm>* rterms = &node.right.expression;
+    if (node.left.lazy && node.left.lazy->op == 't')
+      lterms = &node.left.lazy->left.expression;
+    else if (node.left.lazy) {
+      node.left.expandTerms(ltmp, bop, block);
+      lterms = &ltmp;
+    }
+    if (node.right.lazy && node.right.lazy->op == 't')
+      rterms = &node.right.lazy->left.expression;
+    else if (node.right.lazy) {
+      node.right.expandTerms(rtmp, bop, block);
+      rterms = &rtmp;
     }
-    expression.clear();
-    expression = tmp;
+    size_t first = out.size();
+    multiplyTerms(*lterms, *rterms, out);
+    size_t kept = first;
+    for (size_t i = first; i < out.size(); i++) {
+      if (!keepTerm(out[i])) continue;
+      if (kept != i) out[kept] = std::move(out[i]);
+      kept++;
+    }
+    out.erase(out.begin() + kept, out.end());
+    return;
+  }
+  // implicitBop() does not look into sums, their B operators are expanded whole
+  size_t first = out.size();
+  node.left.expandTerms(out);
+  size_t mid = out.size();
+  node.right.expandTerms(out);
+  if (node.op == '-')
+    for (size_t i = mid; i < out.size(); i++) out[i].neg();
+  size_t kept = first;
+  for (size_t i = first; i < out.size(); i++) {
+    if (!keepTerm(out[i])) continue;
+    if (kept != i) out[kept] = std::move(out[i]);
+    kept++;
   }
+  out.erase(out.begin() + kept, out.end());
+}
+
+void Braket::share() const {
+  if (lazy || expression.empty()) return;
+  shared_ptr<BraketNode> node = make_shared<BraketNode>();
+  node->op = 't';
+  node->left.expression.swap(expression);
+  node->left.operation = operation;
+  node->left.evaluated = evaluated;
+  lazy = node;
 }
 
+void Braket::materialize() const {
+  if (!lazy) return;
+  if (lazy->op == 't') {
+    // copy on write: the terms are taken back if no other expression uses them
+    if (lazy.use_count() == 1)
+      expression.swap(lazy->left.expression);
+    else
+      expression = lazy->left.expression;
+    lazy.reset();
+    return;
+  }
+  if (getVerbosity() >= VERBOSE) cout << "Expanding deferred expression..." << endl;
+  vector<BraketOneTerm> terms;
+  // an implicit B operator is expanded BOP_BLOCK_SIZE monomials at a time, the whole operator is never stored
+  const Braket* bop = implicitBop();
+  if (bop == NULL)
+    expandTerms(terms);
+  else
+    for (size_t b = 0; b * BOP_BLOCK_SIZE < bop->lazy->count; b++) expandTerms(terms, bop, b);
+  lazy.reset();
+  expression.swap(terms);
+}
+
+/*! \brief While true, GetLeviCivita does not register the indices t1,...,tN but only records the largest one used
+    (set by Braket::evaluateTerms while its threads run, so that they never write to the index table) */
+static bool DeferLeviCivitaIds = false;
+/*! \brief Largest index t? used by GetLeviCivita while DeferLeviCivitaIds is true */
+static atomic<int> MaxLeviCivitaId(0);
+
 string GetLeviCivita(vector<string> id0, vector<string> id1) {
   string epsB = "e_(";
   string epsBdagger = "e_(";
@@ -766,7 +1634,12 @@ string GetLeviCivita(vector<string> id0, vector<string> id1) {
     int len = getDim() / 2 - id0.size();
     for (int j = 0; j < len; j++) {
       string addrem = "t" + ToString<int>(idadd);
-      newId(addrem);
+      if (DeferLeviCivitaIds) {
+        int used = MaxLeviCivitaId;
+        while (used < idadd && !MaxLeviCivitaId.compare_exchange_weak(used, idadd)) {
+        }
+      } else
+        newId(addrem);
       factor *= idadd;
       idadd++;
       epsB += addrem;
@@ -784,15 +1657,93 @@ string GetLeviCivita(vector<string> id0, vector<string> id1) {
   return levciviexp;
 }
 
+/*! \brief Permutations of 0, ..., k-1 and their signs */
+struct PermutationTable {
+  vector<vector<unsigned char> > perm;
+  vector<int> sign;
+};
+
+/*! \brief Returns the permutation table of k elements, built once */
+static const PermutationTable& Permutations(size_t k) {
+  static mutex lock;
+  static vector<shared_ptr<const PermutationTable> > tables(LEVI_CIVITA_MAX_NATIVE + 1);
+  lock_guard<mutex> guard(lock);
+  if (!tables[k]) {
+    shared_ptr<PermutationTable> t = make_shared<PermutationTable>();
+    vector<unsigned char> p(k);
+    for (size_t i = 0; i < k; i++) p[i] = i;
+    do {
+      // the sign is the parity of the number of inversions
+      int sign = 1;
+      for (size_t i = 0; i < k; i++)
+        for (size_t j = i + 1; j < k; j++)
+          if (p[i] > p[j]) sign = -sign;
+      t->perm.push_back(p);
+      t->sign.push_back(sign);
+    } while (next_permutation(p.begin(), p.end()));
+    tables[k] = t;
+  }
+  return *tables[k];
+}
+
+static inline bool IsNumber(const string& id) {
+  return !id.empty() && id.find_first_not_of("0123456789") == string::npos;
+}
+
+/*! \brief Contracts GetLeviCivita(id0, id1) over the indices t?, ie, expands the determinant of
+    d_(id0[i], id1[k-1-j]). The deltas of two numbers are evaluated, d_(x,x) is the dimension N.
+    \param[out] out terms of the determinant, each one an integer and a product of deltas (empty if it is a number)
+    \return false if the contraction is longer than LEVI_CIVITA_MAX_NATIVE or gives more than LEVI_CIVITA_MAX_TERMS
+    products of deltas, it is then left to FORM
+*/
+static bool ContractLeviCivita(const vector<string>& id0, const vector<string>& id1,
+                               vector<pair<long long, string> >& out) {
+  size_t k = id0.size();
+  if (k != id1.size() || k > LEVI_CIVITA_MAX_NATIVE) return false;
+  const PermutationTable& table = Permutations(k);
+  unordered_map<string, size_t> seen;
+  for (size_t p = 0; p < table.perm.size(); p++) {
+    long long value = table.sign[p];
+    string deltas;
+    for (size_t i = 0; i < k && value != 0; i++) {
+      const string& a = id0[i];
+      const string& b = id1[k - 1 - table.perm[p][i]];
+      if (a == b)
+        value *= IsNumber(a) ? 1 : getDim() / 2;
+      else if (IsNumber(a) && IsNumber(b))
+        value = 0;
+      else {
+        if (!deltas.empty()) deltas += '*';
+        deltas += "d_(" + a + "," + b + ")";
+      }
+    }
+    if (value == 0) continue;
+    unordered_map<string, size_t>::iterator it = seen.find(deltas);
+    if (it != seen.end())
+      out[it->second].first += value;
+    else {
+      if (out.size() == LEVI_CIVITA_MAX_TERMS) return false;
+      seen[deltas] = out.size();
+      out.push_back(make_pair(value, deltas));
+    }
+  }
+  return true;
+}
+
 /*! \brief Convert current expression term to levi-civita
     and writes all in the string/constant part only if expression term is a
-   braket \param oper expression type, OPMode
+   braket. After setNativeLeviCivita() the levi-civita products are contracted here
+   and a term that gives a number is written as a number.
+   \param oper expression type, OPMode
+   \return true if the term gives zero
 */
-void BraketOneTerm::EvaluateEps_2ndPass(OPMode oper) {
-  if (oper != braket) return;
+bool BraketOneTerm::EvaluateEps_2ndPass(OPMode oper) {
+  if (oper != braket) return false;
+  SOSPIN_PHASE(phase, PHASE_EPS_2NDPASS, term.size());
   list<DList>::iterator iter = term.begin();
-  string constpartout = "*(\n";
-  if (constpart.empty()) constpartout = "(\n";
+  string constpartout = "(\n";
+  bool symbolic = false;
+  long long number = 0;
   while (iter != term.end()) {
     if ((*iter).isEmpty() == false) {
       vector<string> id0;
@@ -800,9 +1751,30 @@ void BraketOneTerm::EvaluateEps_2ndPass(OPMode oper) {
       int sign0 = 1;
       bool bandbdagger = false;
       (*iter).getBandBdaggerIds(bandbdagger, id0, id1, sign0);
+      string deltas = printDeltas((*iter));
+      vector<pair<long long, string> > det;
+      if (FlagNativeLeviCivita && ContractLeviCivita(id0, id1, det)) {
+        for (size_t i = 0; i < det.size(); i++) {
+          long long value = sign0 * det[i].first;
+          if (value == 0) continue;
+          if (deltas.empty() && det[i].second.empty()) {
+            number += value;
+            continue;
+          }
+          symbolic = true;
+          constpartout += value < 0 ? "-" : "+";
+          if (value != 1 && value != -1) constpartout += to_string(value < 0 ? -value : value) + "*";
+          constpartout += deltas;
+          if (!deltas.empty() && !det[i].second.empty()) constpartout += "*";
+          constpartout += det[i].second;
+          constpartout += "\n";
+        }
+        ++iter;
+        continue;
+      }
+      symbolic = true;
       if (sign0 == -1) constpartout += "-";
       if (sign0 == 1) constpartout += "+";
-      string deltas = printDeltas((*iter));
       constpartout += deltas;
       if (bandbdagger && deltas.empty() == false) constpartout += "*";
       if (bandbdagger) constpartout += GetLeviCivita(id0, id1);
@@ -810,10 +1782,18 @@ void BraketOneTerm::EvaluateEps_2ndPass(OPMode oper) {
     }
     ++iter;
   }
-  constpartout += ")";
   term.clear();
-  constpart += constpartout;
-  constpartout.clear();
+  // one summand per line after "(\n"
+  SOSPIN_PHASE_OUT(phase, count(constpartout.begin(), constpartout.end(), '\n') - 1 + (number != 0));
+  if (FlagNativeLeviCivita && !symbolic) {
+    if (number == 0) return true;
+    constpart *= Coefficient(to_string(number));
+    return false;
+  }
+  if (number != 0) constpartout += (number > 0 ? "+" : "") + to_string(number) + "\n";
+  constpartout += ")";
+  constpart *= Coefficient::atom(constpartout);
+  return false;
 }
 
 /*!
@@ -821,8 +1801,10 @@ void BraketOneTerm::EvaluateEps_2ndPass(OPMode oper) {
   in right side \param[in,out] Toeval expression term to evaluate \param oper
   expression type, OPMode
 */
-void OrderBandBdaggers(list<DList>& Toeval, OPMode oper) {
-  list<DList>::iterator iter = Toeval.begin();
+template <class DListContainer>
+void OrderBandBdaggers(DListContainer& Toeval, OPMode oper) {
+  SOSPIN_PHASE(phase, PHASE_ORDER_B, Toeval.size());
+  typename DListContainer::iterator iter = Toeval.begin();
   bool braketmode = false;
   if (oper == braket) braketmode = true;
   while (iter != Toeval.end()) {
@@ -874,6 +1856,7 @@ void OrderBandBdaggers(list<DList>& Toeval, OPMode oper) {
     }
     if (inc_iter) ++iter;
   }
+  SOSPIN_PHASE_OUT(phase, Toeval.size());
 }
 
 /*!
@@ -881,8 +1864,10 @@ void OrderBandBdaggers(list<DList>& Toeval, OPMode oper) {
   equal to N of SO(N) \param[in,out] Toeval expression term to evaluate \param
   oper expression type, OPMode
 */
-void ReduceNumberOfBandBdaggers(list<DList>& Toeval, OPMode oper) {
-  list<DList>::iterator iter = Toeval.begin();
+template <class DListContainer>
+void ReduceNumberOfBandBdaggers(DListContainer& Toeval, OPMode oper) {
+  SOSPIN_PHASE(phase, PHASE_REDUCE_B, Toeval.size());
+  typename DListContainer::iterator iter = Toeval.begin();
   bool braketmode = false;
   if (oper == braket) braketmode = true;
   while (iter != Toeval.end()) {
@@ -923,6 +1908,7 @@ void ReduceNumberOfBandBdaggers(list<DList>& Toeval, OPMode oper) {
         }
     if (inc_iter) ++iter;
   }
+  SOSPIN_PHASE_OUT(phase, Toeval.size());
 }
 
 /*! \brief Reduce number of b's plus b\dagger's to 2N of SO(2N),
@@ -931,11 +1917,20 @@ void ReduceNumberOfBandBdaggers(list<DList>& Toeval, OPMode oper) {
     \return true if expression is zero/empty and false otherwise
 */
 bool BraketOneTerm::EvaluateEps_1stPass(OPMode oper) {
-  // evaluate expression in order to have b's+b^daggers <= N of SO(N)
-  ReduceNumberOfBandBdaggers(term, oper);
-  // evaluate expression in order to have all b's at the left side and b^daggers
-  // at right side
-  OrderBandBdaggers(term, oper);
+  if (EvalArena::current() != 0) {
+    // the intermediate terms live in the current evaluation arena
+    EvalList work(term.begin(), term.end());
+    term.clear();
+    ReduceNumberOfBandBdaggers(work, oper);
+    OrderBandBdaggers(work, oper);
+    term.assign(work.begin(), work.end());
+  } else {
+    // evaluate expression in order to have b's+b^daggers <= N of SO(N)
+    ReduceNumberOfBandBdaggers(term, oper);
+    // evaluate expression in order to have all b's at the left side and b^daggers
+    // at right side
+    OrderBandBdaggers(term, oper);
+  }
   if (term.empty()) return true;
   return false;
 }
@@ -947,19 +1942,24 @@ bool BraketOneTerm::EvaluateEps_1stPass(OPMode oper) {
 bool BraketOneTerm::EvaluateToLeviCivita(OPMode oper) {
   EvaluateEps_1stPass(oper);
   if (term.empty()) return true;
-  EvaluateEps_2ndPass(oper);
+  if (EvaluateEps_2ndPass(oper)) {
+    constpart.clear();
+    index = 0;
+    return true;
+  }
   return false;
 }
 
-/*! \brief Evaluate the expression term to deltas
-  \param[in] oper term mode (bra, braket, ket or none)
-  \return true if term is empty or gives zero, otherwise returns false
+/*!
+  \brief Contract all b's with b^daggers of the expression until only deltas are left
+  \param[in,out] Toeval expression term to evaluate \param oper expression type, OPMode
 */
-bool BraketOneTerm::EvaluateToDeltas(OPMode oper) {
-  list<DList>::iterator iter = term.begin();
+template <class DListContainer>
+void ContractToDeltas(DListContainer& Toeval, OPMode oper) {
+  typename DListContainer::iterator iter = Toeval.begin();
   bool braketmode = false;
   if (oper == braket) braketmode = true;
-  while (iter != term.end()) {
+  while (iter != Toeval.end()) {
     bool inc_iter = true;
     if ((*iter).isEmpty() == false)
       if ((*iter).search_last(0))
@@ -974,21 +1974,21 @@ bool BraketOneTerm::EvaluateToDeltas(OPMode oper) {
             if (oper == ket || oper == braket) {
               M.search_last(0);
               if (M.isActualLast() == false) {
-                term.push_back(M);
+                Toeval.push_back(M);
               }
             } else
-              term.push_back(M);
+              Toeval.push_back(M);
           }
           if (L.isEmpty()) {
             (*iter).clear();
-            iter = term.erase(iter);
+            iter = Toeval.erase(iter);
             inc_iter = false;
             break;
           } else if (oper == ket || oper == braket) {
             L.search_last(0);
             if (L.isActualLast()) {
               (*iter).clear();
-              iter = term.erase(iter);
+              iter = Toeval.erase(iter);
               inc_iter = false;
               break;
             }
@@ -997,6 +1997,39 @@ bool BraketOneTerm::EvaluateToDeltas(OPMode oper) {
         }
     if (inc_iter) ++iter;
   }
+}
+
+/*! \brief Evaluate the expression term to deltas
+  \param[in] oper term mode (bra, braket, ket or none)
+  \return true if term is empty or gives zero, otherwise returns false
+*/
+bool BraketOneTerm::EvaluateToDeltas(OPMode oper) {
+  SOSPIN_PHASE(phase, PHASE_EVAL_DELTAS, term.size());
+  if (EvalArena::current() != 0) {
+    EvalList work(term.begin(), term.end());
+    term.clear();
+    ContractToDeltas(work, oper);
+    term.assign(work.begin(), work.end());
+  } else
+    ContractToDeltas(term, oper);
+  SOSPIN_PHASE_OUT(phase, term.size());
+  if (term.empty()) {
+    constpart.clear();
+    index = 0;
+    return true;
+  }
+  return false;
+}
+
+/*! \brief Evaluate the expression term to deltas using Wick's theorem
+  \param[in] oper term mode (bra, braket, ket or none)
+  \return true if term is empty or gives zero, otherwise returns false
+*/
+bool BraketOneTerm::EvaluateWick(OPMode oper) {
+  if (oper != braket) return EvaluateToDeltas(oper);
+  vector<DList> result;
+  for (list<DList>::const_iterator iter = term.begin(); iter != term.end(); ++iter) wick_contract(*iter, result);
+  term.assign(result.begin(), result.end());
   if (term.empty()) {
     constpart.clear();
     index = 0;
@@ -1005,51 +2038,230 @@ bool BraketOneTerm::EvaluateToDeltas(OPMode oper) {
   return false;
 }
 
+bool BraketOneTerm::EvaluateFock(bool onlydeltas, bool& zero) {
+  if (term.empty()) return false;
+  list<DList>::const_iterator iter;
+  for (iter = term.begin(); iter != term.end(); ++iter)
+    if (!isNumeric(*iter)) return false;
+  SOSPIN_PHASE(phase, PHASE_EVAL_FOCK, term.size());
+  // the monomials applied to the vacuum, their sum projected on the vacuum
+  FockState ket;
+  for (iter = term.begin(); iter != term.end(); ++iter) {
+    FockState s = FockState::vacuum();
+    s.apply(*iter);
+    ket.add(s, (*iter).getSign());
+  }
+  long long value = ket.amplitude(0);
+  term.clear();
+  zero = value == 0;
+  if (zero) {
+    constpart.clear();
+    index = 0;
+    return true;
+  }
+  SOSPIN_PHASE_OUT(phase, 1);
+  constpart *= Coefficient(to_string(value));
+  // evaluated to deltas a number is kept as the identity, simplify() removes the terms left empty
+  if (onlydeltas) term.push_back(DList(ct, 0));
+  return true;
+}
+
 /*! \brief Evaluate expression
     \param[in] onlydeltas if true evaluate expression to deltas, if false
    evaluate expression to levi-civita
+    \param[in] method ITERATIVE or WICK, the latter only applies to brakets evaluated to deltas
 */
-void Braket::evaluate(bool onlydeltas) {
+void Braket::evaluate(bool onlydeltas, EvalMethod method) {
   if (getVerbosity() >= VERBOSE) cout << "Evaluating Expression..." << endl;
   if (getVerbosity() == DEBUG_VERBOSE) print_process_mem_usage();
-  simplify();
+  // a product with an implicit B operator is expanded and evaluated a block at a time, not simplified whole first
+  bool blocks = evaluated == 0 && (onlydeltas || operation == braket) && EvalMemoryBudget == 0 && implicitBop();
+  if (!blocks) simplify();
   if (evaluated == 0) {
     if (getVerbosity() == DEBUG_VERBOSE) print_process_mem_usage();
-    if (onlydeltas) {
-      vector<BraketOneTerm>::iterator iter = expression.begin();
-      int i = 0;
-      int total = expression.size();
-      DoProgress("Progress: ", i, total);
-      while (iter != expression.end()) {
-        if ((*iter).EvaluateToDeltas(operation)) {
-          (*iter).clear();
-          iter = expression.erase(iter);
-        } else
-          ++iter;
-        i++;
-        DoProgress("Progress: ", i, total);
-      }
-      if (operation == braket) evaluated = 1;
-    } else {
-      if (operation != braket) return;
-      int i = 0;
-      int total = expression.size();
-      DoProgress("Progress: ", i, total);
-      vector<BraketOneTerm>::iterator iter = expression.begin();
-      while (iter != expression.end()) {
-        if ((*iter).EvaluateToLeviCivita(operation)) {
-          (*iter).clear();
-          iter = expression.erase(iter);
-        } else
-          ++iter;
-        i++;
-        DoProgress("Progress: ", i, total);
-      }
-      if (operation == braket) evaluated = 2;
-    }
+    if (!onlydeltas && operation != braket) return;
+    if (blocks)
+      evaluateBlocks(onlydeltas, method);
+    else if (EvalMemoryBudget > 0)
+      evaluateSpilled(onlydeltas, method);
+    else
+      evaluateTerms(onlydeltas, method);
+    if (operation == braket) evaluated = onlydeltas ? 1 : 2;
     if (getVerbosity() == DEBUG_VERBOSE) print_process_mem_usage();
   }
-  if (evaluated > 0) gindexsetnull();
+  // evaluateSpilled() already set the index sums to zero
+  if (evaluated > 0 && !spilled()) gindexsetnull();
+  if (FlagCollectTerms) collect();
+}
+
+/*! \brief Evaluate one expression term
+    \param[in,out] term expression term
+    \param[in] oper term mode (bra, braket, ket or none)
+    \param[in] onlydeltas if true evaluate to deltas, if false evaluate to levi-civita
+    \param[in] method ITERATIVE or WICK
+    \return true if the term gives zero
+*/
+static bool EvaluateOneTerm(BraketOneTerm& term, OPMode oper, bool onlydeltas, EvalMethod method) {
+  bool zero;
+  if (FlagFockEvaluation && oper == braket && term.EvaluateFock(onlydeltas, zero)) return zero;
+  if (!onlydeltas) return term.EvaluateToLeviCivita(oper);
+  if (method == WICK) return term.EvaluateWick(oper);
+  return term.EvaluateToDeltas(oper);
+}
+
+/*! \brief Evaluate every expression term using getThreads() threads and remove the terms that give zero.
+    The terms are independent, each thread takes the next term not yet evaluated and
+    the remaining terms keep their order, so the result does not depend on the number of threads.
+    \param[in] onlydeltas if true evaluate expression to deltas, if false evaluate expression to levi-civita
+    \param[in] method ITERATIVE or WICK
+*/
+void Braket::evaluateTerms(bool onlydeltas, EvalMethod method) {
+  size_t total = expression.size();
+  vector<char> zero(total, 0);
+  Progress progress("Progress: ", total);
+  size_t nthreads = getThreads();
+  if (nthreads > total) nthreads = total;
+  if (nthreads <= 1) {
+    for (size_t i = 0; i < total; i++) {
+      zero[i] = EvaluateOneTerm(expression[i], operation, onlydeltas, method);
+      progress.set(i + 1);
+    }
+  } else {
+    // the threads only read the index table, the indices t? of the levi-civita terms are registered at the end
+    DeferLeviCivitaIds = true;
+    MaxLeviCivitaId = 0;
+    atomic<size_t> next(0);
+    // the arena of the caller only serves its own thread, each worker opens one and merges it at the end
+    EvalArena* arena = EvalArena::current();
+    mutex arenamutex;
+    vector<thread> workers;
+    for (size_t t = 0; t < nthreads; t++)
+      workers.push_back(thread([&]() {
+        unique_ptr<EvalArena> local;
+        if (arena) local.reset(new EvalArena(arena->chunkBytes()));
+        size_t i;
+        while ((i = next++) < total) {
+          zero[i] = EvaluateOneTerm(expression[i], operation, onlydeltas, method);
+          progress.add();
+        }
+        if (local) {
+          lock_guard<mutex> lock(arenamutex);
+          arena->merge(*local);
+        }
+      }));
+    for (size_t t = 0; t < nthreads; t++) workers[t].join();
+    DeferLeviCivitaIds = false;
+    for (int j = 1; j <= MaxLeviCivitaId; j++) newId("t" + ToString<int>(j));
+  }
+  size_t kept = 0;
+  for (size_t i = 0; i < total; i++) {
+    if (zero[i]) continue;
+    if (kept != i) expression[kept] = std::move(expression[i]);
+    kept++;
+  }
+  expression.erase(expression.begin() + kept, expression.end());
+}
+
+void Braket::evaluateBlocks(bool onlydeltas, EvalMethod method) {
+  const Braket* bop = implicitBop();
+  size_t blocks = (bop->lazy->count + BOP_BLOCK_SIZE - 1) / BOP_BLOCK_SIZE;
+  vector<BraketOneTerm> result;
+  Braket part;
+  part.operation = operation;
+  part.evaluated = evaluated;
+  for (size_t b = 0; b < blocks; b++) {
+    // expandTerms() already applied rearrange() and simplify() to each term
+    expandTerms(part.expression, bop, b);
+    part.evaluateTerms(onlydeltas, method);
+    for (size_t i = 0; i < part.expression.size(); i++) result.push_back(std::move(part.expression[i]));
+    part.expression.clear();
+  }
+  lazy.reset();
+  expression.swap(result);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////
+// Out-of-core evaluation, see setEvalMemoryBudget()
+bool Braket::spilled() const { return lazy && lazy->op == 'f'; }
+
+/*! \brief Estimated memory used by one expression term, in bytes */
+static size_t TermBytes(BraketOneTerm& term) {
+  size_t bytes = sizeof(BraketOneTerm) - sizeof(Coefficient) + term.GetCoef().bytes();
+  for (list<DList>::const_iterator iter = term.GetTerm().begin(); iter != term.GetTerm().end(); iter++) {
+    // list node and, past the inline storage, the heap array of the monomial
+    bytes += sizeof(DList) + 2 * sizeof(void*);
+    if (iter->size() > DLIST_INLINE_SIZE) bytes += iter->size() * sizeof(elemType);
+  }
+  return bytes;
+}
+
+/*! \brief Returns a new file name in the spill directory, unique in this process */
+static string SpillPath() {
+  static atomic<int> count(0);
+  ostringstream name;
+  name << EvalSpillDir << "/sospin_" << getpid() << "_" << count++ << ".spill";
+  return name.str();
+}
+
+void Braket::evaluateSpilled(bool onlydeltas, EvalMethod method) {
+  size_t total = expression.size();
+  string input = SpillPath();
+  vector<char> outbuf(1 << 20);
+  ofstream spill;
+  spill.rdbuf()->pubsetbuf(outbuf.data(), outbuf.size());
+  spill.open(input.c_str(), ios::binary | ios::trunc);
+  for (size_t i = 0; i < total && spill; i++) PutTerm(spill, expression[i]);
+  spill.close();
+  if (spill.fail()) {
+    cout << "Cannot write spill file: " << input << endl;
+    exit(1);
+  }
+  vector<BraketOneTerm>().swap(expression);
+  shared_ptr<BraketNode> node = make_shared<BraketNode>();
+  node->op = 'f';
+  node->path = SpillPath();
+  spill.open(node->path.c_str(), ios::binary | ios::trunc);
+  ifstream in(input.c_str(), ios::binary);
+  BraketStreamReader reader(in);
+  // the chunk size follows the memory used per input term, term plus results, in the previous chunk
+  size_t chunk = MAX((size_t)getThreads(), (size_t)1);
+  size_t chunks = 0;
+  for (size_t first = 0; first < total; chunks++) {
+    size_t n = MIN(chunk, total - first);
+    expression.resize(n);
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; i++) {
+      GetTerm(reader, expression[i], NULL);
+      bytes += TermBytes(expression[i]);
+    }
+    if (!reader.ok) {
+      cout << "Error reading " << input << endl;
+      exit(1);
+    }
+    evaluateTerms(onlydeltas, method);
+    for (size_t i = 0; i < expression.size(); i++) {
+      if (operation == braket) expression[i].GetIndex() = 0;
+      bytes += TermBytes(expression[i]);
+      PutTerm(spill, expression[i]);
+    }
+    node->count += expression.size();
+    vector<BraketOneTerm>().swap(expression);
+    first += n;
+    chunk = MAX(EvalMemoryBudget / MAX(bytes / n, (size_t)1), (size_t)1);
+  }
+  in.close();
+  remove(input.c_str());
+  spill.close();
+  if (spill.fail()) {
+    cout << "Cannot write spill file: " << node->path << endl;
+    exit(1);
+  }
+  lazy = node;
+  if (getVerbosity() >= VERBOSE)
+    cout << "Evaluated " << total << " terms in " << chunks << " chunks, " << node->count << " terms kept in "
+         << node->path << "; RSS_Peak: " << getPeakRSS() / (1024. * 1024.) << " (MB), memory budget: "
+         << EvalMemoryBudget / (1024. * 1024.) << " (MB)" << endl;
 }
 
 }  // namespace sospin
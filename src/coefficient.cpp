@@ -0,0 +1,212 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//       coefficient.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Constant part of the Braket terms, kept as a rational number times a product of factors.
+*/
+
+#include <sospin/coefficient.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace sospin {
+
+/*! \brief Largest numerator or denominator folded in a prefactor */
+static const long long COEFFICIENT_MAX = 1LL << 62;
+
+template <class T>
+static T Gcd(T a, T b) {
+  if (a < 0) a = -a;
+  while (b) {
+    T t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/*! \brief Sets r = a * b if |a * b| < COEFFICIENT_MAX, returns false otherwise */
+static bool MulSmall(long long a, long long b, long long &r) {
+  unsigned long long ua = a < 0 ? 0ULL - (unsigned long long)a : (unsigned long long)a;
+  unsigned long long ub = b < 0 ? 0ULL - (unsigned long long)b : (unsigned long long)b;
+  if (ub != 0 && ua > (unsigned long long)(COEFFICIENT_MAX - 1) / ub) return false;
+  r = a * b;
+  return true;
+}
+
+/*! \brief Reads an integer or fraction p/q of at most 18 digits each, with an optional sign
+    \return false if text is not such a number
+*/
+static bool ParseRational(const string &text, long long &num, long long &den) {
+  size_t i = 0, n = text.size();
+  bool negative = false;
+  if (i < n && (text[i] == '+' || text[i] == '-')) negative = text[i++] == '-';
+  long long part[2] = {0, 1};
+  for (int p = 0; p < 2; p++) {
+    size_t first = i;
+    long long v = 0;
+    while (i < n && text[i] >= '0' && text[i] <= '9' && i - first < 18) v = 10 * v + (text[i++] - '0');
+    if (i == first) return false;
+    part[p] = v;
+    if (i == n) break;
+    if (p == 1 || text[i] != '/') return false;
+    i++;
+  }
+  if (i != n || part[1] == 0) return false;
+  long long g = Gcd<long long>(part[0], part[1]);
+  if (g == 0) g = 1;
+  num = negative ? -part[0] / g : part[0] / g;
+  den = part[1] / g;
+  return true;
+}
+
+Coefficient::Coefficient() : num(1), den(1), numeric(false) {}
+
+Coefficient::Coefficient(const string &text) : num(1), den(1), numeric(false) {
+  string t;
+  t.reserve(text.size());
+  for (size_t i = 0; i < text.size(); i++)
+    if (text[i] != ' ') t += text[i];
+  if (t.empty()) return;
+  if (ParseRational(t, num, den))
+    numeric = true;
+  else
+    atoms.push_back(make_shared<const string>(std::move(t)));
+}
+
+Coefficient Coefficient::atom(const string &text) {
+  Coefficient c;
+  if (!text.empty()) c.atoms.push_back(make_shared<const string>(text));
+  return c;
+}
+
+Coefficient Coefficient::sum(const vector<Coefficient> &addends, const vector<int> &signs) {
+  string out = "(";
+  for (size_t i = 0; i < addends.size(); i++) {
+    if (i > 0) out += signs[i] > 0 ? "+" : "-";
+    out += '(';
+    if (addends[i].empty())
+      out += '1';
+    else
+      addends[i].appendTo(out);
+    out += ')';
+  }
+  out += ')';
+  return atom(out);
+}
+
+bool Coefficient::rational(long long &n, long long &d) const {
+  if (!atoms.empty()) return false;
+  n = num;
+  d = den;
+  return true;
+}
+
+void Coefficient::clear() {
+  num = den = 1;
+  numeric = false;
+  atoms.clear();
+}
+
+void Coefficient::negate() {
+  num = -num;
+  numeric = true;
+}
+
+Coefficient &Coefficient::operator*=(const Coefficient &c) {
+  if (c.numeric) {
+    // the prefactors are folded while they stay small, otherwise the one of c is kept as an atom
+    long long g1 = Gcd<long long>(num, c.den), g2 = Gcd<long long>(c.num, den);
+    long long n, d;
+    if (MulSmall(num / g1, c.num / g2, n) && MulSmall(den / g2, c.den / g1, d)) {
+      num = n;
+      den = d;
+      numeric = true;
+    } else {
+      Coefficient factor = c;
+      factor.atoms.clear();
+      atoms.push_back(make_shared<const string>(factor.str()));
+    }
+  }
+  atoms.insert(atoms.end(), c.atoms.begin(), c.atoms.end());
+  return *this;
+}
+
+Coefficient operator*(const Coefficient &a, const Coefficient &b) {
+  Coefficient c = a;
+  c *= b;
+  return c;
+}
+
+static void AppendInteger(string &out, long long n) {
+  char buf[24];
+  int len = 0;
+  unsigned long long v = n < 0 ? 0ULL - (unsigned long long)n : (unsigned long long)n;
+  do {
+    buf[len++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  if (n < 0) out += '-';
+  while (len) out += buf[--len];
+}
+
+void Coefficient::appendTo(string &out) const {
+  if (numeric && (atoms.empty() || num != 1 || den != 1)) {
+    AppendInteger(out, num);
+    if (den != 1) {
+      out += '/';
+      AppendInteger(out, den);
+    }
+    if (!atoms.empty()) out += '*';
+  }
+  for (size_t i = 0; i < atoms.size(); i++) {
+    if (i > 0) out += '*';
+    out += *atoms[i];
+  }
+}
+
+string Coefficient::str() const {
+  string out;
+  appendTo(out);
+  return out;
+}
+
+size_t Coefficient::bytes() const {
+  size_t n = sizeof(Coefficient) + atoms.capacity() * sizeof(shared_ptr<const string>);
+  for (size_t i = 0; i < atoms.size(); i++) n += atoms[i]->capacity();
+  return n;
+}
+
+}  // namespace sospin
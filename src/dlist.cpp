@@ -34,112 +34,111 @@
 //      Revision 1.2 26/05/2015 09:02:00 nunogon
 //      License updated
 //      Revision 1.3 12/09/2023 16:53:51 david
+//      Revision 1.4 17/10/2026 contiguous storage for the monomial
 
 /*!
   \file
   \brief Definitions for all general (initialisation etc.) routines of class DList.
 */
 
+#include <sospin/arena.h>
 #include <sospin/dlist.h>
 #include <sospin/index.h>
 #include <sospin/son.h>
 
+#include <algorithm>
+
 namespace sospin {
 
 /*! \brief Default constructor*/
 DList::DList(void) {
-  begin = 0;
-  end = 0;
-  actual = 0;
+  data = local;
+  length = 0;
+  capacity = DLIST_INLINE_SIZE;
+  actual = -1;
   sign = 1;
 }
 
 /*!
-\brief Constructor - node of element of type "tp" and first data field "i". Pointer are initialized with NULL.
+\brief Constructor - DList with one element of type "tp" and first data field "i".
 \param tp symbol type
 \param i index symbol
 */
 DList::DList(int tp, int i) {
-  begin = new noList();
-  begin->data = elemType::make_elem(tp, i);
-  begin->prv = 0;
-  begin->nxt = 0;
-  actual = begin;
-  end = begin;
+  data = local;
+  capacity = DLIST_INLINE_SIZE;
+  data[0] = elemType::make_elem(tp, i);
+  length = 1;
+  actual = 0;
   sign = 1;
 }
 
-/*! \brief Constructor - node of element of type "tp", first data field "i" and second data field "j". Pointer are initialized with NULL.
+/*! \brief Constructor - DList with one element of type "tp", first data field "i" and second data field "j".
 \param tp symbol type
 \param i first index symbol
 \param j second index symbol
 */
 DList::DList(int tp, int i, int j) {
-  begin = new noList();
-  begin->data = elemType::make_elem(tp, i, j);
-  begin->prv = 0;
-  begin->nxt = 0;
-  actual = begin;
-  end = begin;
+  data = local;
+  capacity = DLIST_INLINE_SIZE;
+  data[0] = elemType::make_elem(tp, i, j);
+  length = 1;
+  actual = 0;
   sign = 1;
 }
 
 /*! \brief Constructor by copy.*/
 DList::DList(const DList& L) {
-  begin = 0;
-  end = 0;
-  actual = 0;
+  data = local;
+  length = 0;
+  capacity = DLIST_INLINE_SIZE;
+  actual = -1;
   sign = 1;
-  if (!L.begin) return;
-  this->sign = L.sign;
-  noList *q, *p, *k;
-  q = L.begin;
-  if (q != 0) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = 0;
-    p->nxt = 0;
-    this->begin = p;
-    this->end = p;
-    k = begin;
-    q = q->nxt;
-    while (q != 0) {
-      p = new noList();
-      p->data = (q->data);
-      p->prv = k;
-      p->nxt = 0;
-      k->nxt = p;
-      this->end = p;
-      q = q->nxt;
-      k = k->nxt;
-    }
-    this->actual = p;
-  }
+  if (L.length == 0) return;
+  assign(L);
 }
 
 /*!\brief Destructor*/
 DList::~DList(void) {
-  clear();
+  if (data != local) EvalArena::deallocate(data);
+}
+
+// Storage
+
+/*! \brief Makes room for at least "n" elements, keeping the current ones. The buffer comes from the current EvalArena, if any.*/
+void DList::reserve(unsigned int n) {
+  if (n <= capacity) return;
+  unsigned int newcapacity = capacity * 2;
+  if (newcapacity < n) newcapacity = n;
+  elemType* newdata = static_cast<elemType*>(EvalArena::allocate(newcapacity * sizeof(elemType)));
+  memcpy(newdata, data, length * sizeof(elemType));
+  if (data != local) EvalArena::deallocate(data);
+  data = newdata;
+  capacity = newcapacity;
+}
+
+/*! \brief Copies elements and sign of L, the actual position is set to the last element.*/
+void DList::assign(const DList& L) {
+  length = 0;
+  reserve(L.length);
+  memcpy(data, L.data, L.length * sizeof(elemType));
+  length = L.length;
+  sign = L.sign;
+  actual = last();
+}
+
+/*! \brief Removes "n" elements starting at position "pos".*/
+void DList::erase(unsigned int pos, unsigned int n) {
+  memmove(data + pos, data + pos + n, (length - pos - n) * sizeof(elemType));
+  length -= n;
 }
 
 // Changing, writing and updating
 
-/*!\brief Delete all nodes from DList*/
+/*!\brief Delete all elements from DList. The heap buffer, if any, is kept for reuse.*/
 void DList::clear() {
-  if (begin) {
-    noList* seg;
-    actual = begin;
-    seg = actual->nxt;
-    while (seg != 0) {
-      delete (actual);
-      actual = seg;
-      seg = seg->nxt;
-    }
-    delete (actual);
-  }
-  actual = 0;
-  begin = 0;
-  end = 0;
+  length = 0;
+  actual = -1;
   sign = 1;
 }
 
@@ -148,25 +147,7 @@ void DList::clear() {
 \param elem symbol to be added
 */
 void DList::add(elemType elem) {
-  noList *q, *p;
-  if (!begin) {
-    begin = new noList();
-    begin->data = elem;
-    begin->prv = 0;
-    begin->nxt = 0;
-    actual = begin;
-    end = begin;
-  } else {
-    q = begin;
-    while (q->nxt != 0) q = q->nxt;
-    p = new noList();
-    p->data = elem;
-    p->prv = q;
-    p->nxt = 0;
-    q->nxt = p;
-    actual = p;
-    end = p;
-  }
+  add_end(elem);
 }
 
 /*!
@@ -174,23 +155,11 @@ void DList::add(elemType elem) {
 \param elem symbol to be added
 */
 void DList::add_begin(elemType elem) {
-  noList* p;
-  if (begin == 0) {
-    begin = new noList();
-    begin->data = elem;
-    begin->prv = 0;
-    begin->nxt = 0;
-    actual = begin;
-    end = begin;
-  } else {
-    p = new noList();
-    p->data = elem;
-    p->prv = 0;
-    p->nxt = begin;
-    begin->prv = p;
-    begin = p;
-    actual = p;
-  }
+  reserve(length + 1);
+  memmove(data + 1, data, length * sizeof(elemType));
+  data[0] = elem;
+  length++;
+  actual = 0;
 }
 
 /*!
@@ -198,23 +167,10 @@ void DList::add_begin(elemType elem) {
 \param elem symbol to be added
 */
 void DList::add_end(elemType elem) {
-  noList* p;
-  if (!begin) {
-    begin = new noList();
-    begin->data = elem;
-    begin->prv = 0;
-    begin->nxt = 0;
-    actual = begin;
-    end = begin;
-  } else {
-    p = new noList();
-    p->data = elem;
-    p->prv = end;
-    p->nxt = 0;
-    end->nxt = p;
-    end = p;
-    actual = p;
-  }
+  reserve(length + 1);
+  data[length] = elem;
+  actual = length;
+  length++;
 }
 
 /*! \brief Joins a DList to the end of the current DList (this). Updates "actual" pointer to be the end of the final DList.
@@ -222,137 +178,96 @@ void DList::add_end(elemType elem) {
 k.join(q) = k q
 */
 void DList::join(DList& L) {
-
-  noList *k, *p, *q;
-  q = L.begin;
-  k = begin;
-  if (!begin) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = 0;
-    p->nxt = 0;
-    begin = p;
-    end = k;
-    k = begin;
-    q = q->nxt;
-  } else
-    while (k->nxt != 0) k = k->nxt;
-  while (q != 0) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = k;
-    p->nxt = 0;
-    k->nxt = p;
-    end = k;
-    q = q->nxt;
-    k = k->nxt;
-  }
-  actual = end;
+  reserve(length + L.length);
+  memcpy(data + length, L.data, L.length * sizeof(elemType));
+  length += L.length;
+  actual = last();
 }
 
 /*! \brief Creates and returns a new DList by copying nodes in DList ordered by type. The nodes that first appear in the new ordered DList are $\delta$'s (type=2) and then all other elements: $b$ (type=0) and $b^\dagger$ (type=1) unordered. Constant elements are removed.*/
-DList DList::rearrange() {
+DList DList::rearrange() const {
   DList M;
   M.sign = sign;
-  noList* q;
-  q = begin;
-  if (q != 0) {
-    if (q->nxt == 0)
-      M.add_end(q->data);
-    else {
-      while (q != 0) {
-        if (q->data.getType() == 2) M.add_end(q->data);
-        q = q->nxt;
-      }
-      q = begin;
-      while (q != 0) {
-        if (q->data.getType() == 0 || q->data.getType() == 1) M.add_end(q->data);
-        q = q->nxt;
-      }
+  if (length == 1)
+    M.add_end(data[0]);
+  else if (length > 1) {
+    M.reserve(length);
+    for (unsigned int i = 0; i < length; i++)
+      if (data[i].getType() == 2) M.data[M.length++] = data[i];
+    for (unsigned int i = 0; i < length; i++)
+      if (data[i].getType() == 0 || data[i].getType() == 1) M.data[M.length++] = data[i];
+    M.actual = M.last();
+  }
+  return M;
+}
+
+/*! \brief Orders $\delta$ elements by their packed word */
+static bool deltaLess(const elemType& a, const elemType& b) { return a.dataField < b.dataField; }
+
+DList DList::canonical() const {
+  DList M = rearrange();
+  // deltas are in front after rearrange(), d_(i,j) = d_(j,i)
+  unsigned int n = 0;
+  while (n < M.length && M.data[n].getType() == 2) {
+    unsigned int i0 = M.data[n].getIdx1();
+    unsigned int i1 = M.data[n].getIdx2();
+    if (i1 < i0) {
+      M.data[n].setIdx1(i1);
+      M.data[n].setIdx2(i0);
     }
+    n++;
   }
+  sort(M.data, M.data + n, deltaLess);
   return M;
 }
 
+unsigned long long DList::hash() const {
+  // FNV-1a over the packed elements
+  unsigned long long h = 14695981039346656037ULL;
+  for (unsigned int i = 0; i < length; i++) {
+    unsigned long long w = data[i].dataField;
+    for (unsigned int k = 0; k < sizeof(data[i].dataField); k++) {
+      h ^= (w >> (8 * k)) & 0xff;
+      h *= 1099511628211ULL;
+    }
+  }
+  return h;
+}
+
+bool DList::sameElements(const DList& M) const {
+  if (length != M.length) return false;
+  for (unsigned int i = 0; i < length; i++)
+    if (data[i].dataField != M.data[i].dataField) return false;
+  return true;
+}
+
 /*! \brief Removes the first element with "data.get\_type()==type" found in DList. Updates actual pointer to be the first node.*/
 void DList::remove(unsigned int type) {
-  actual = begin;
-  noList* next;
-  noList* prv;
-  if (begin) {
-    prv = 0;
-    while (actual != 0) {
-      if (actual->data.getType() == type) {
-        if (prv == 0)
-          begin = actual->nxt;
-        else
-          prv->nxt = actual->nxt;
-        if (actual->nxt == 0)
-          end = prv;
-        else {
-          next = actual->nxt;
-          next->prv = actual->prv;
-        }
-        delete (actual);
-        actual = begin;
-        return;
-      }
-      prv = actual;
-      actual = actual->nxt;
+  for (unsigned int i = 0; i < length; i++) {
+    if (data[i].getType() == type) {
+      erase(i, 1);
+      break;
     }
   }
-  actual = begin;
+  set_begin();
 }
 
 /*! \brief Removes the element for which the actual pointer, "actual", is pointing at in DList.*/
 void DList::remove_actual() {
-  noList* next;
-  noList* prv;
-  if (begin)
-    if (actual != 0) {
-      prv = 0;
-      if (actual->prv == 0)
-        begin = actual->nxt;
-      else {
-        prv = actual->prv;
-        prv->nxt = actual->nxt;
-      }
-      if (actual->nxt == 0)
-        end = prv;
-      else {
-        next = actual->nxt;
-        next->prv = actual->prv;
-      }
-      delete (actual);
-      // length--;
-      // if(beg==end) empty = true;
-      actual = begin;
-      return;
-    }
+  if (length == 0 || actual < 0) return;
+  erase(actual, 1);
+  set_begin();
 }
 
-/*! \brief Swaps the actual node with the next node of DList.*/
+/*! \brief Swaps the actual node with the next node of DList. The actual pointer follows the swapped node.*/
 void DList::swap_next() {
-  if (!actual || (actual->nxt) == 0)
+  if (actual < 0 || actual >= last())
     cout << "swap empty list or end of list" << endl;
   else {
-    noList *before, *after, *after2;
-    after2 = 0;
-    before = actual->prv;
-    after = actual->nxt;
-    if (after->nxt != 0)
-      after2 = after->nxt;
-    else
-      end = actual;
-    if (before != 0)
-      before->nxt = after;
-    else
-      begin = after;
-    actual->nxt = after2;
-    if (after2 != 0) after2->prv = actual;
-    after->prv = before;
-    actual->prv = after;
-    after->nxt = actual;
+    elemType tmp = data[actual];
+    data[actual] = data[actual + 1];
+    data[actual + 1] = tmp;
+    actual++;
   }
 }
 
@@ -361,19 +276,14 @@ void DList::swap_next() {
 /*! \brief Creates and returns an integer vector sequence container with the ids (data fields) of $b$'s and $b^\dagger$'s elements.*/
 vector<int> DList::getIds() {
   vector<int> ids;
-  if (begin != 0) {
-    noList* q;
-    q = begin;
-    while (q != 0) {
-      switch (q->data.getType()) {
-        case 0:
-          ids.push_back(0);
-          break;
-        case 1:
-          ids.push_back(1);
-          break;
-      }
-      q = q->nxt;
+  for (unsigned int i = 0; i < length; i++) {
+    switch (data[i].getType()) {
+      case 0:
+        ids.push_back(0);
+        break;
+      case 1:
+        ids.push_back(1);
+        break;
     }
   }
   return ids;
@@ -382,22 +292,18 @@ vector<int> DList::getIds() {
 /*! \brief Updates integer vector sequence containers "id0" and "id1" with ids (data fields) of $b$'s and $b^\dagger$'s elements, respectively. "sign" is updated with the sign of DList. "BandBdagger" is a boolean which is true if DList contains at least one $b$ or $b^\dagger$, and false otherwise.*/
 void DList::getBandBdaggerIds(bool& BandBdagger, vector<string>& id0, vector<string>& id1, int& sign) {
   BandBdagger = false;
-  if (begin != 0) {
-    noList* q;
-    q = begin;
-    sign = getSign();
-    while (q != 0) {
-      switch (q->data.getType()) {
-        case 0:
-          id0.push_back(getIdx(q->data.getIdx1()));
-          BandBdagger = true;
-          break;
-        case 1:
-          id1.push_back(getIdx(q->data.getIdx1()));
-          BandBdagger = true;
-          break;
-      }
-      q = q->nxt;
+  if (length == 0) return;
+  sign = getSign();
+  for (unsigned int i = 0; i < length; i++) {
+    switch (data[i].getType()) {
+      case 0:
+        id0.push_back(getIdx(data[i].getIdx1()));
+        BandBdagger = true;
+        break;
+      case 1:
+        id1.push_back(getIdx(data[i].getIdx1()));
+        BandBdagger = true;
+        break;
     }
   }
 }
@@ -405,29 +311,15 @@ void DList::getBandBdaggerIds(bool& BandBdagger, vector<string>& id0, vector<str
 /*! \brief Updates integer vector sequence containers "id0" and "id1" with first and second ids (data fields) of $\delta$ elements, respectively. "sign" is updated with the sign of DList. "AllDeltas" is a boolean which is true if all elements in DList are of $\delta$ type, and false otherwise.*/
 void DList::getDeltaIds(bool& AllDeltas, vector<string>& id0, vector<string>& id1, int& sign) {
   bool expwithAllDelta = false;
-  if (begin != 0) {
-    noList* q;
-    q = begin;
+  if (length != 0) {
     sign = getSign();
     bool alldeltas = true;
-    while (q != 0) {
-      switch (q->data.getType()) {
-        case 0:
-          alldeltas = false;
-          break;
-        case 1:
-          alldeltas = false;
-          break;
-        case 2:
-          id0.push_back(getIdx(q->data.getIdx1()));
-          id1.push_back(getIdx(q->data.getIdx2()));
-          break;
-        case 3:
-          alldeltas = false;
-          break;
-      }
-      if (alldeltas == false) break;
-      q = q->nxt;
+    for (unsigned int i = 0; i < length && alldeltas; i++) {
+      if (data[i].getType() == 2) {
+        id0.push_back(getIdx(data[i].getIdx1()));
+        id1.push_back(getIdx(data[i].getIdx2()));
+      } else
+        alldeltas = false;
     }
     if (alldeltas) expwithAllDelta = true;
   }
@@ -437,62 +329,38 @@ void DList::getDeltaIds(bool& AllDeltas, vector<string>& id0, vector<string>& id
 /*! \brief Updates integer vector sequence containers "id0" and "id1" with ids (data fields) of $b$'s and $b^\dagger$'s elements, respectively, and "id2" and "id3" integer vector sequence containers with first and second data fields of $\delta$'s elements, respectively. "sign" is updated with the sign of DList.*/
 void DList::getBandBdaggerAndDeltasIds(vector<string>& id0, vector<string>& id1,
                                        vector<string>& id2, vector<string>& id3, int& sign) {
-  if (begin != 0) {
-    noList* q;
-    q = begin;
-    sign = getSign();
-    while (q != 0) {
-      switch (q->data.getType()) {
-        case 0:
-          id0.push_back(getIdx(q->data.getIdx1()));
-          break;
-        case 1:
-          id1.push_back(getIdx(q->data.getIdx1()));
-          break;
-        case 2:
-          id2.push_back(getIdx(q->data.getIdx1()));
-          id3.push_back(getIdx(q->data.getIdx2()));
-          break;
-      }
-      q = q->nxt;
+  if (length == 0) return;
+  sign = getSign();
+  for (unsigned int i = 0; i < length; i++) {
+    switch (data[i].getType()) {
+      case 0:
+        id0.push_back(getIdx(data[i].getIdx1()));
+        break;
+      case 1:
+        id1.push_back(getIdx(data[i].getIdx1()));
+        break;
+      case 2:
+        id2.push_back(getIdx(data[i].getIdx1()));
+        id3.push_back(getIdx(data[i].getIdx2()));
+        break;
     }
   }
 }
 
 /*! \brief Returns the number of elements of type $\delta$ (type=2).*/
 int DList::numDeltas() {
-  if (begin == 0)
-    return 0;
-  else {
-    noList* q;
-    q = begin;
-    int alldeltas = 0;
-    while (q != 0) {
-      if (q->data.getType() == 2) {
-        alldeltas++;
-      }
-      q = q->nxt;
-    }
-    return alldeltas;
-  }
+  int alldeltas = 0;
+  for (unsigned int i = 0; i < length; i++)
+    if (data[i].getType() == 2) alldeltas++;
+  return alldeltas;
 }
 
 /*! \brief Returns the number of elements of type b (type=0).*/
 int DList::numBs() {
-  if (begin == 0)
-    return 0;
-  else {
-    noList* q;
-    q = begin;
-    int numbs = 0;
-    while (q != 0) {
-      if (q->data.getType() == 0) {
-        numbs++;
-      }
-      q = q->nxt;
-    }
-    return numbs;
-  }
+  int numbs = 0;
+  for (unsigned int i = 0; i < length; i++)
+    if (data[i].getType() == 0) numbs++;
+  return numbs;
 }
 
 /*! \brief Search the last element with "data.get\_type()==type1" found in DList. Returns true a node was found.
@@ -500,13 +368,13 @@ int DList::numBs() {
 \return @a TRUE if the symbol is not the last, @a FALSE otherwise
 */
 bool DList::search_last(unsigned int type) {
-  if (!begin) return false;
-  actual = end;
-  while (actual != 0) {
-    if (actual->data.getType() == type) break;
-    actual = actual->prv;
+  if (length == 0) return false;
+  actual = last();
+  while (actual >= 0) {
+    if (data[actual].getType() == type) break;
+    actual--;
   }
-  if (actual == end) return false;
+  if (actual == last()) return false;
   return true;
 }
 
@@ -516,13 +384,15 @@ bool DList::search_last(unsigned int type) {
 \return @a TRUE if the symbol is not the first, @a FALSE otherwise
 */
 bool DList::search_first(unsigned int type1) {
-  if (!begin) return false;
-  actual = begin;
-  while (actual != 0) {
-    if (actual->data.getType() == type1) break;
-    actual = actual->nxt;
+  if (length == 0) return false;
+  actual = -1;
+  for (unsigned int i = 0; i < length; i++) {
+    if (data[i].getType() == type1) {
+      actual = i;
+      break;
+    }
   }
-  if (actual == begin) return false;
+  if (actual == 0) return false;
   return true;
 }
 
@@ -533,17 +403,17 @@ bool DList::search_first(unsigned int type1) {
 */
 // NG: devia alterar-se o nome da funcao.
 bool DList::search_first(unsigned int type0, unsigned int type1) {
-  if (!begin) return false;
-  actual = begin;
+  if (length == 0) return false;
+  actual = -1;
   bool opb = false;
   bool elem = true;
-  while (actual != 0) {
-    if (actual->data.getType() == type0) {
+  for (unsigned int i = 0; i < length; i++) {
+    if (data[i].getType() == type0) {
+      actual = i;
       elem = false;
       break;
-    } else if (actual->data.getType() == type1)
+    } else if (data[i].getType() == type1)
       opb = true;
-    actual = actual->nxt;
   }
   if (opb) elem = true;
   return elem;
@@ -554,13 +424,15 @@ bool DList::search_first(unsigned int type0, unsigned int type1) {
 \return @a TRUE if the element is found
 */
 bool DList::search_elem(unsigned int type1) {
-  if (!begin) return false;
-  actual = begin;
-  while (actual != 0) {
-    if (actual->data.getType() == type1) break;
-    actual = actual->nxt;
+  if (length == 0) return false;
+  actual = -1;
+  for (unsigned int i = 0; i < length; i++) {
+    if (data[i].getType() == type1) {
+      actual = i;
+      break;
+    }
   }
-  if (actual == 0) return false;
+  if (actual < 0) return false;
   return true;
 }
 
@@ -570,232 +442,156 @@ bool DList::search_elem(unsigned int type1) {
 \return @a TRUE if number of b's and b^\\dagger's are equal and they are all within bounds, @a FALSE otherwise.
 */
 bool DList::check() {
-  if (!begin)
-    return false;
-  else {
-    actual = begin;
-    int zero = 0;
-    int um = 0;
-    while (actual != 0) {
-      if (actual->data.getType() == 0) zero++;
-      if (actual->data.getType() == 1) um++;
-      actual = actual->nxt;
-    }
-    if (um == zero && um <= getDim() / 2 && zero <= getDim() / 2) return true;
-    return false;
+  if (length == 0) return false;
+  actual = -1;
+  int zero = 0;
+  int um = 0;
+  for (unsigned int i = 0; i < length; i++) {
+    if (data[i].getType() == 0) zero++;
+    if (data[i].getType() == 1) um++;
   }
+  if (um == zero && um <= getDim() / 2 && zero <= getDim() / 2) return true;
+  return false;
+}
+
+/*! \brief Returns true if the delta "elem" is zero: its indices are two different numbers in 1..n,
+    or one of them is a number above n of SO(2n).
+*/
+static inline bool zeroDelta(const elemType& elem, int nson) {
+  // numeric values of the indices, 0 if symbolic
+  int id0 = getIdxValue(elem.getIdx1());
+  int id1 = getIdxValue(elem.getIdx2());
+  // two different numeric indices in 1..n give zero
+  if (elem.getIdx1() != elem.getIdx2())
+    if (id0 > 0 && id0 <= nson && id1 > 0 && id1 <= nson && id0 != id1) return true;
+  return id0 > nson || id1 > nson;
 }
 
 /*! \brief Checks the indexes of $\delta$ elements. They must be less or equal to the n of SO(2n). Checks also if the the indexes of a delta are equal. Returns true if each $\delta$ is not zero, false otherwise.
 \return @c TRUE if each delta is not zero, @c FALSE otherwise
 */
-// NG: rever esta função. Parece-me que pode estar errada.
 bool DList::checkDeltaIndex() {
-  if (!begin) return false;
-  actual = begin;
+  if (length == 0) return false;
   bool elem = true;
   int nson = getDim() / 2;
-  while (actual != 0) {
-    if (actual->data.getType() == 2) {
-      string id0 = getIdx(actual->data.getIdx1());
-      string id1 = getIdx(actual->data.getIdx2());
-      if (id0 == id1) {
-        if (atoi(id0.c_str()) <= nson)
-          if (atoi(id0.c_str()) > 0)
-            if (atoi(id1.c_str()) <= nson)
-              if (atoi(id1.c_str()) > 0)
-                if (atoi(id0.c_str()) != atoi(id1.c_str())) {
-                  break;
-                }
-      } else {
-        if (atoi(id0.c_str()) <= nson)
-          if (atoi(id0.c_str()) > 0)
-            if (atoi(id1.c_str()) <= nson)
-              if (atoi(id1.c_str()) > 0)
-                if (atoi(id0.c_str()) != atoi(id1.c_str())) {
-                  elem = false;
-                  break;
-                }
-      }
-      if (atoi(id0.c_str()) > nson || atoi(id1.c_str()) > nson) {
-        elem = false;
-        break;
-      }
+  for (actual = 0; actual < static_cast<int>(length); actual++) {
+    if (data[actual].getType() == 2 && zeroDelta(data[actual], nson)) {
+      elem = false;
+      break;
     }
-    actual = actual->nxt;
   }
+  if (actual == static_cast<int>(length)) actual = -1;
 
   return elem;
 }
 
+MonomialInfo DList::info() const {
+  MonomialInfo out;
+  out.nb = 0;
+  out.nbt = 0;
+  out.first = -1;
+  out.last = -1;
+  out.deltas = true;
+  int nson = getDim() / 2;
+  for (unsigned int i = 0; i < length; i++) {
+    unsigned int type = data[i].getType();
+    if (type == 0 || type == 1) {
+      if (type == 0)
+        out.nb++;
+      else
+        out.nbt++;
+      if (out.first < 0) out.first = type;
+      out.last = type;
+    } else if (type == 2 && out.deltas && zeroDelta(data[i], nson))
+      out.deltas = false;
+  }
+  return out;
+}
+
 /*! \brief Verifies if the number of $b$'s and $b^\dagger$'s is less or equal than N of SO(2N). Returns true if so, false otherwise.*/
 bool DList::check_num() {
-  if (!begin)
-    return false;
-  else {
-    actual = begin;
-    int zero = 0;
-    int um = 0;
-    while (actual != 0) {
-      if (actual->data.getType() == 0) zero++;
-      if (actual->data.getType() == 1) um++;
-      actual = actual->nxt;
-    }
-    if (um <= getDim() / 2 && zero <= getDim() / 2) return true;
-    return false;
+  if (length == 0) return false;
+  actual = -1;
+  int zero = 0;
+  int um = 0;
+  for (unsigned int i = 0; i < length; i++) {
+    if (data[i].getType() == 0) zero++;
+    if (data[i].getType() == 1) um++;
   }
+  if (um <= getDim() / 2 && zero <= getDim() / 2) return true;
+  return false;
 }
 
 /*! \brief Verifies if the number of $b$'s and $b^\dagger$'s match. Returns true if they match, false otherwise.*/
 bool DList::check_same_num() {
-  if (!begin)
-    return false;
-  else {
-    actual = begin;
-    int zero = 0;
-    int um = 0;
-    while (actual != 0) {
-      if (actual->data.getType() == 0) zero++;
-      if (actual->data.getType() == 1) um++;
-      actual = actual->nxt;
-    }
-    if (um == zero) return true;
-    return false;
+  if (length == 0) return false;
+  actual = -1;
+  int zero = 0;
+  int um = 0;
+  for (unsigned int i = 0; i < length; i++) {
+    if (data[i].getType() == 0) zero++;
+    if (data[i].getType() == 1) um++;
   }
+  if (um == zero) return true;
+  return false;
 }
 
 /*! \brief Returns true if there is no elements of type $\delta$ in DList.*/
 bool DList::hasNoDeltas() {
-  if (begin == 0)
-    return true;
-  else {
-    noList* q;
-    q = begin;
-    bool nodeltas = true;
-    while (q != 0) {
-      if (q->data.getType() == 2) {
-        nodeltas = false;
-        break;
-      }
-      if (nodeltas == false) break;
-      q = q->nxt;
-    }
-    return nodeltas;
-  }
+  for (unsigned int i = 0; i < length; i++)
+    if (data[i].getType() == 2) return false;
+  return true;
 }
 
 /*! \brief Returns true if all nodes in DList are of $\delta$ type.*/
 bool DList::hasOnlyDeltas() {
-  if (begin == 0)
-    return false;
-  else {
-    noList* q;
-    q = begin;
-    bool alldeltas = true;
-    while (q != 0) {
-      if (q->data.getType() != 2) {
-        alldeltas = false;
-        break;
-      }
-      q = q->nxt;
-    }
-    return alldeltas;
-  }
+  if (length == 0) return false;
+  for (unsigned int i = 0; i < length; i++)
+    if (data[i].getType() != 2) return false;
+  return true;
 }
 
 /*! \brief Returns true if there is elements with the same id (data fields) in the DList (repeated ids).*/
 bool DList::hasRepeatedIndex() {
-  vector<string> id0;
-  bool repid = false;
-  if (begin != 0) {
-    noList* q;
-    q = begin;
-    while (q != 0) {
-      switch (q->data.getType()) {
-        case 0:
-          id0.push_back(getIdx(q->data.getIdx1()));
-          break;
-        case 1:
-          id0.push_back(getIdx(q->data.getIdx1()));
-          break;
-        case 2:
-          id0.push_back(getIdx(q->data.getIdx1()));
-          id0.push_back(getIdx(q->data.getIdx2()));
-          break;
-      }
-      q = q->nxt;
+  // indices are interned, so equal names have equal positions in the index table
+  unsigned int ids[2 * DLIST_INLINE_SIZE];
+  vector<unsigned int> heapids;
+  unsigned int* id0 = ids;
+  if (length > DLIST_INLINE_SIZE) {
+    heapids.resize(2 * length);
+    id0 = &heapids[0];
+  }
+  unsigned int size = 0;
+  for (unsigned int i = 0; i < length; i++) {
+    switch (data[i].getType()) {
+      case 0:
+      case 1:
+        id0[size++] = data[i].getIdx1();
+        break;
+      case 2:
+        id0[size++] = data[i].getIdx1();
+        id0[size++] = data[i].getIdx2();
+        break;
     }
-    unsigned int size = id0.size();
-    sort(id0.begin(), id0.end());
-    vector<string>::iterator it;
-    it = unique(id0.begin(), id0.end());
-    id0.resize(it - id0.begin());
-    if (size != id0.size())
-      repid = true;
   }
-  return repid;
+  sort(id0, id0 + size);
+  return adjacent_find(id0, id0 + size) != id0 + size;
 }
 
 // Operators
 
-/*! \brief Copies a DList.*/
+/*! \brief Copies a DList. Copying an empty DList leaves the current DList unchanged.*/
 DList& DList::operator=(const DList& L) {
-  if (!L.begin) return *this;
-  sign = L.sign;
-  noList *q, *p, *k;
-  q = L.begin;
-  if (q != 0) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = 0;
-    p->nxt = 0;
-    begin = p;
-    end = p;
-    k = begin;
-    q = q->nxt;
-    while (q != 0) {
-      p = new noList();
-      p->data = (q->data);
-      p->prv = k;
-      p->nxt = 0;
-      k->nxt = p;
-      end = p;
-      q = q->nxt;
-      k = k->nxt;
-    }
-    actual = p;
-  }
+  if (L.length == 0 || &L == this) return *this;
+  assign(L);
   return *this;
 }
 
 /*! \brief Negates operator, change sign of DList.*/
 const DList DList::operator-() const {
   DList L;
+  L.assign(*this);
   L.sign = -1 * sign;
-  noList *q, *p, *k;
-  q = begin;
-  k = L.begin;
-  if (q != 0) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = 0;
-    p->nxt = 0;
-    L.begin = p;
-    L.end = p;
-    k = L.begin;
-    q = q->nxt;
-    while (q != 0) {
-      p = new noList();
-      p->data = (q->data);
-      p->prv = k;
-      p->nxt = 0;
-      k->nxt = p;
-      L.end = p;
-      q = q->nxt;
-      k = k->nxt;
-    }
-    L.actual = L.end;
-  }
   return L;
 }
 
@@ -803,33 +599,8 @@ const DList DList::operator-() const {
 
 /*! \brief Creates and returns a pointer to a new copy of a DList.*/
 DList* copy(DList* L) {
-  DList* M = 0;
-  noList *q, *p, *k;
-  q = L->begin;
-  if (q != 0) {
-    M = new DList();
-    M->sign = L->sign;
-    p = new noList();
-    p->data = (q->data);
-    p->prv = 0;
-    p->nxt = 0;
-    M->begin = p;
-    M->end = p;
-    k = M->begin;
-    q = q->nxt;
-    while (q != 0) {
-      p = new noList();
-      p->data = (q->data);
-      p->prv = k;
-      p->nxt = 0;
-      k->nxt = p;
-      M->end = p;
-      q = q->nxt;
-      k = k->nxt;
-    }
-    M->actual = p;
-  }
-  return M;
+  if (L->length == 0) return 0;
+  return new DList(*L);
 }
 
 /*! \brief Applies the following identity:
@@ -846,55 +617,34 @@ DList contract_deltas(DList& L, bool braketmode) {
 
   if (L.isEmpty()) return M;
 
-  elemType bb;
-  elemType bdag;
-
-  if (L.begin == 0) return M;
-
   L.search_last(0);
-  if (L.actual == L.end) {
+  if (L.actual == L.last()) {
     if (braketmode) L.clear();
     return M;
   }
-  if (L.actual == 0) return M;
-  M << L;
+  if (L.actual < 0) return M;
+  int pos = L.actual;
+  elemType bb = L.data[pos];
+  elemType bdag = L.data[pos + 1];
+  if (bb.getType() != 0 || bdag.getType() != 1) return M;
+
+  // swapped term: - ... b^\dagger_j * b_i ...
+  M.assign(L);
   M.set_sign(-1 * L.getSign());
-  M.search_last(0);
-  noList* elem = M.actual;
-  bb = elem->data;
-  bdag = elem->nxt->data;
-  if (bb.getType() != 0 || bdag.getType() != 1) {
-    DList A;
-    return A;
-  }
+  M.data[pos] = bdag;
+  M.data[pos + 1] = bb;
+  // the cursor follows the swapped b, as DList::swap_next() does
+  M.actual = pos + 1;
+
+  // contracted term: \delta_{i,j} ... (without b_i * b^\dagger_j)
   elemType delta;
   delta.setType(2);
   delta.setIdx1(bb.getIdx1());
   delta.setIdx2(bdag.getIdx1());
-  L.add_begin(delta);
-  L.search_last(0);
-
-  noList* elem1 = L.actual;
-  noList *before, *after, *after2;
-  after2 = 0;
-  before = elem1->prv;
-  L.actual = L.actual->prv;
-  after = elem1->nxt;
-  L.actual = after;
-  if (after != 0) after2 = after->nxt;
-  L.actual = after2;
-  if (before != 0)
-    before->nxt = after2;
-  else
-    L.begin = 0;
-  L.actual = L.begin;
-  if (after2 != 0) after2->prv = before;
-  if (after2 == 0) L.end = before;
-  delete elem1;
-  if (after != 0) delete after;
-
-  M.search_last(0);
-  M.swap_next();
+  memmove(L.data + 1, L.data, pos * sizeof(elemType));
+  L.data[0] = delta;
+  L.erase(pos + 1, 1);
+  L.actual = 0;
   return M;
 }
 
@@ -913,79 +663,121 @@ DList ordering(DList& L, bool braketmode) {
 
   if (L.isEmpty()) return M;
 
-  elemType bb;
-  elemType bdag;
-
-  if (L.begin == 0) return M;
-
   L.search_first(1);
-  if (L.actual == L.begin) {
+  if (L.actual == 0) {
     if (braketmode) L.clear();
     return M;
   }
-  if (L.actual == 0) return M;
-  M << L;
-  M.set_sign(-1 * L.getSign());
-  M.search_first(1);
-  L.search_first(1);
-  noList* elemM = M.actual;
-  noList* elemL = L.actual;
-  bdag = elemM->data;
-  bb = elemM->nxt->data;
-  while (true) {
-    if (bb.getType() == 0 && bdag.getType() == 1) break;
-    elemM = elemM->nxt;
-    elemL = elemL->nxt;
-    bdag = elemM->data;
-    bb = elemM->nxt->data;
+  if (L.actual < 0) return M;
+  int pos = L.actual;
+  while (pos + 1 < static_cast<int>(L.length)) {
+    if (L.data[pos].getType() == 1 && L.data[pos + 1].getType() == 0) break;
+    pos++;
   }
-  M.actual = elemM;
-  L.actual = elemL;
+  if (pos + 1 >= static_cast<int>(L.length)) return M;
+  elemType bdag = L.data[pos];
+  elemType bb = L.data[pos + 1];
+
+  // swapped term: - ... b_i * b^\dagger_j ...
+  M.assign(L);
+  M.set_sign(-1 * L.getSign());
+  M.data[pos] = bb;
+  M.data[pos + 1] = bdag;
+
+  // contracted term: \delta_{i,j} ... (without b^\dagger_j * b_i)
   elemType delta;
   delta.setType(2);
   delta.setIdx1(bb.getIdx1());
   delta.setIdx2(bdag.getIdx1());
-
-  noList* elem1 = L.actual;
-  noList *before, *after, *after2;
-  after2 = 0;
-  before = elem1->prv;
-  L.actual = L.actual->prv;
-  after = elem1->nxt;
-  L.actual = after;
-  if (after != 0) after2 = after->nxt;
-  L.actual = after2;
-  if (before != 0)
-    before->nxt = after2;
-  else
-    L.begin = 0;
-  L.actual = L.begin;
-  if (after2 != 0) after2->prv = before;
-  if (after2 == 0) L.end = before;
-  delete elem1;
-  if (after != 0) delete after;
-  L.add_begin(delta);
-
-  M.swap_next();
+  memmove(L.data + 1, L.data, pos * sizeof(elemType));
+  L.data[0] = delta;
+  L.erase(pos + 1, 1);
+  L.actual = 0;
   return M;
 }
 
+/*! \brief Recursive step of wick_contract: pairs the first free operator with each free b^\dagger at its right.
+  \param[in] ops b and b^\dagger elements of the monomial
+  \param[in,out] used operators already paired
+  \param[in,out] deltas deltas of the pairs made so far
+  \param[in] sign sign of the pairings made so far
+  \param[out] products deltas of each complete pairing, one after the other
+  \param[out] signs sign of each complete pairing
+*/
+static void wick_pairings(const vector<elemType>& ops, vector<char>& used, vector<elemType>& deltas, int sign,
+                          vector<elemType>& products, vector<int>& signs) {
+  size_t p = 0;
+  while (p < ops.size() && used[p]) p++;
+  if (p == ops.size()) {
+    products.insert(products.end(), deltas.begin(), deltas.end());
+    signs.push_back(sign);
+    return;
+  }
+  // <0| b^\dagger = 0
+  if (ops[p].getType() != 0) return;
+  used[p] = 1;
+  int between = 0;
+  for (size_t q = p + 1; q < ops.size(); q++) {
+    if (used[q]) continue;
+    if (ops[q].getType() == 1) {
+      used[q] = 1;
+      deltas.push_back(elemType::make_delta(ops[p], ops[q]));
+      wick_pairings(ops, used, deltas, (between % 2 == 0) ? sign : -sign, products, signs);
+      deltas.pop_back();
+      used[q] = 0;
+    }
+    between++;
+  }
+  used[p] = 0;
+}
+
+void wick_contract(const DList& L, vector<DList>& out) {
+  vector<elemType> ops;
+  vector<elemType> rest;
+  for (unsigned int i = 0; i < L.length; i++) {
+    if (L.data[i].getType() == 0 || L.data[i].getType() == 1)
+      ops.push_back(L.data[i]);
+    else
+      rest.push_back(L.data[i]);
+  }
+  if (ops.empty()) {
+    out.push_back(L);
+    return;
+  }
+  if (ops.size() % 2 != 0) return;
+  vector<char> used(ops.size(), 0);
+  vector<elemType> deltas;
+  vector<elemType> products;
+  vector<int> signs;
+  wick_pairings(ops, used, deltas, L.sign, products, signs);
+
+  // each term: the new deltas followed by the deltas and constants already in L
+  unsigned int npairs = ops.size() / 2;
+  unsigned int n = npairs + rest.size();
+  size_t first = out.size();
+  out.resize(first + signs.size());
+  for (size_t k = 0; k < signs.size(); k++) {
+    DList& D = out[first + k];
+    D.reserve(n);
+    memcpy(D.data, &products[k * npairs], npairs * sizeof(elemType));
+    if (!rest.empty()) memcpy(D.data + npairs, &rest[0], rest.size() * sizeof(elemType));
+    D.length = n;
+    D.actual = n - 1;
+    D.sign = signs[k];
+  }
+}
+
 // NG: o "*" deveria ser colocado tb para type=3, não?
 /*! \brief Creates and returns a string with the deltas and constants of a DList.*/
 string printDeltas(DList& L) {
   string deltas = "";
-  if (!L.begin) return deltas;
-  noList* q;
-  q = L.begin;
-
-  while (q != 0) {
-    if (q->data.getType() == 2)
-      deltas += "d_(" + getIdx(q->data.getIdx1()) + "," + getIdx(q->data.getIdx2()) + ")";
-    if (q->data.getType() == 3)
+  for (unsigned int i = 0; i < L.length; i++) {
+    if (L.data[i].getType() == 2)
+      deltas += "d_(" + getIdx(L.data[i].getIdx1()) + "," + getIdx(L.data[i].getIdx2()) + ")";
+    if (L.data[i].getType() == 3)
       deltas += "1";
-    q = q->nxt;
-    if (q != 0)
-      if (q->data.getType() == 2) deltas += "*";
+    if (i + 1 < L.length)
+      if (L.data[i + 1].getType() == 2) deltas += "*";
   }
   return deltas;
 }
@@ -1001,46 +793,16 @@ DList& operator*(DList& L, elemType j) {
 /*! \brief Creates and returns new DList that joins two DLists by order of parameters.*/
 DList operator*(const DList& O, const DList& P) {
   DList L;
+  L.reserve(O.length + P.length);
+  memcpy(L.data, O.data, O.length * sizeof(elemType));
+  L.length = O.length;
   L.sign = O.sign * P.sign;
-  noList *q, *p, *k;
-  q = O.begin;
-  k = L.begin;
-  if (q != 0) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = 0;
-    p->nxt = 0;
-    L.begin = p;
-    k = L.begin;
-    L.end = p;
-    q = q->nxt;
-    while (q != 0) {
-      p = new noList();
-      p->data = (q->data);
-      p->prv = k;
-      p->nxt = 0;
-      k->nxt = p;
-      L.end = p;
-      q = q->nxt;
-      k = k->nxt;
-    }
-  }
-  q = P.begin;
-  while (q != 0) {
-    if ((O.begin != 0 || q->nxt != 0) && q->data.getType() == 3) {
-      q = q->nxt;
-      continue;
-    }
-    p = new noList();
-    p->data = (q->data);
-    p->prv = k;
-    p->nxt = 0;
-    k->nxt = p;
-    L.end = p;
-    q = q->nxt;
-    k = k->nxt;
+  for (unsigned int i = 0; i < P.length; i++) {
+    // identity elements of the right operand are dropped unless it is the only element
+    if ((O.length != 0 || i + 1 < P.length) && P.data[i].getType() == 3) continue;
+    L.data[L.length++] = P.data[i];
   }
-  L.actual = L.end;
+  L.actual = L.last();
   return L;
 }
 
@@ -1067,26 +829,22 @@ cout << L << endl;
 \endcode
 */
 ostream& operator<<(ostream& out, DList& L) {
-  if (!L.begin) return out << " ";
-  noList* q;
-  q = L.begin;
-  if (q != 0) {
-    out << "\t";
-    if (L.getSign() == -1) out << " - ";
-    if (L.getSign() == 1) out << " + ";
-  }
-  while (q != 0) {
-    if (q->data.getType() == 2)
-      out << "d(" << getIdx(q->data.getIdx1()) << "," << getIdx(q->data.getIdx2()) << ")";
-    if (q->data.getType() == 0)
-      out << "b(" << getIdx(q->data.getIdx1()) << ")";
-    if (q->data.getType() == 1)
-      out << "bt(" << getIdx(q->data.getIdx1()) << ")";
-    if (q->data.getType() == 3)
+  if (L.length == 0) return out << " ";
+  out << "\t";
+  if (L.getSign() == -1) out << " - ";
+  if (L.getSign() == 1) out << " + ";
+  for (unsigned int i = 0; i < L.length; i++) {
+    elemType q = L.data[i];
+    if (q.getType() == 2)
+      out << "d(" << getIdx(q.getIdx1()) << "," << getIdx(q.getIdx2()) << ")";
+    if (q.getType() == 0)
+      out << "b(" << getIdx(q.getIdx1()) << ")";
+    if (q.getType() == 1)
+      out << "bt(" << getIdx(q.getIdx1()) << ")";
+    if (q.getType() == 3)
       out << "1";
-    if (q == L.actual) out << "@";
-    if (q->nxt != 0) out << " * ";
-    q = q->nxt;
+    if (static_cast<int>(i) == L.actual) out << "@";
+    if (i + 1 < L.length) out << " * ";
   }
   return out << " ";
 }
@@ -1094,28 +852,7 @@ ostream& operator<<(ostream& out, DList& L) {
 /*! \brief Sends to output stream ostream a string with the corresponding expression of the DList.*/
 ostream& operator<<(ostream& out, DList* L) {
   if (!L) return out << " ";
-  if (!L->begin) return out << " ";
-  noList* q;
-  q = L->begin;
-  if (q != 0) {
-    out << "\t";
-    if (L->getSign() == -1) out << " - ";
-    if (L->getSign() == 1) out << " + ";
-  }
-  while (q != 0) {
-    if (q->data.getType() == 2)
-      out << "d(" << getIdx(q->data.getIdx1()) << "," << getIdx(q->data.getIdx2()) << ")";
-    if (q->data.getType() == 0)
-      out << "b(" << getIdx(q->data.getIdx1()) << ")";
-    if (q->data.getType() == 1)
-      out << "bt(" << getIdx(q->data.getIdx1()) << ")";
-    if (q->data.getType() == 3)
-      out << "1";
-    if (q == L->actual) out << "@";
-    if (q->nxt != 0) out << " * ";
-    q = q->nxt;
-  }
-  return out << " ";
+  return out << *L;
 }
 
 // same as operator* and operator,
@@ -1136,66 +873,24 @@ L << M << N << O << P;
 \endcode
 */
 DList& operator<<(DList& L, DList& M) {
-  if (!M.begin) return L;
+  if (M.length == 0) return L;
   L.set_sign(L.getSign() * M.getSign());
-  noList *q, *p, *k;
-  q = M.begin;
-  k = L.begin;
-  if (!L.begin) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = 0;
-    p->nxt = 0;
-    L.begin = p;
-    k = L.begin;
-    q = q->nxt;
-    L.end = p;
-  } else
-    while (k->nxt != 0) k = k->nxt;
-  while (q != 0) {
-    p = new noList();
-    p->data = (q->data);
-    p->prv = k;
-    p->nxt = 0;
-    k->nxt = p;
-    L.end = p;
-    q = q->nxt;
-    k = k->nxt;
-  }
-  L.actual = L.end;
+  L.join(M);
   return L;
 }
 
 /*! \brief Returns true if two DLists are equal.*/
 bool operator==(DList& L, DList& M) {
-  if (!M.begin && !L.begin) return true;
+  if (M.length == 0 && L.length == 0) return true;
   if (L.getSign() != M.getSign()) return false;
-
-  noList *q, *k;
-  elemType data0, data1;
-  q = M.begin;
-  k = L.begin;
-  while (true) {
-    data0 = q->data;
-    data1 = k->data;
-    if (data0.getType() != data1.getType()) {
-      return false;
-    }
-    if (getIdx(data0.getIdx1()) != getIdx(data1.getIdx1())) {
-      return false;
-    }
-    if (getIdx(data0.getIdx2()) != getIdx(data1.getIdx2())) {
-      return false;
-    }
-    if (k->nxt != 0 && q->nxt != 0) {
-      k = k->nxt;
-      q = q->nxt;
-    } else {
-      if ((k->nxt != 0) != (q->nxt != 0)) {
-        return false;
-      }
-      break;
-    }
+  if (L.length != M.length) return false;
+
+  for (unsigned int i = 0; i < L.length; i++) {
+    elemType data0 = M.data[i];
+    elemType data1 = L.data[i];
+    if (data0.getType() != data1.getType()) return false;
+    if (data0.getIdx1() != data1.getIdx1()) return false;
+    if (data0.getIdx2() != data1.getIdx2()) return false;
   }
   return true;
 }
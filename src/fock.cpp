@@ -0,0 +1,143 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+//       fock.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Fock space states of the N modes of SO(2N), used to evaluate the brakets whose indices are all numbers.
+*/
+
+#include <sospin/fock.h>
+#include <sospin/index.h>
+#include <sospin/son.h>
+
+#include <bitset>
+
+namespace sospin {
+
+/*! \brief Largest number of modes of an occupation mask */
+static const int FOCK_MAX_MODES = 64;
+
+/*! \brief Number of occupied modes below mode k in m, its parity is the sign of b_k and b^\dagger_k */
+static inline size_t Below(FockState::Mask m, int k) {
+  return bitset<FOCK_MAX_MODES>(m & ((FockState::Mask(1) << (k - 1)) - 1)).count();
+}
+
+FockState FockState::vacuum() {
+  FockState s;
+  s.amp[0] = 1;
+  return s;
+}
+
+void FockState::create(int k) {
+  Mask bit = Mask(1) << (k - 1);
+  map<Mask, long long> out;
+  for (map<Mask, long long>::const_iterator it = amp.begin(); it != amp.end(); ++it) {
+    if (it->first & bit) continue;
+    out[it->first | bit] = Below(it->first, k) % 2 ? -it->second : it->second;
+  }
+  amp.swap(out);
+}
+
+void FockState::annihilate(int k) {
+  Mask bit = Mask(1) << (k - 1);
+  map<Mask, long long> out;
+  for (map<Mask, long long>::const_iterator it = amp.begin(); it != amp.end(); ++it) {
+    if (!(it->first & bit)) continue;
+    out[it->first & ~bit] = Below(it->first, k) % 2 ? -it->second : it->second;
+  }
+  amp.swap(out);
+}
+
+/*! \brief Returns the mode of the index in position "i", 1, 2, ..., or 0 if its name is not a positive number */
+static int Mode(int i) {
+  int k = getIdxValue(i);
+  // getIdxValue() reads the digits in front of names such as "2a", and "-1" is a number of no mode
+  if (k < 1 || tabids[i].find_first_not_of("0123456789") != string::npos) return 0;
+  return k;
+}
+
+bool isNumeric(const DList &d) {
+  for (unsigned int i = 0; i < d.size(); i++) {
+    const elemType &elem = d.at(i);
+    switch (elem.getType()) {
+      case 2:
+        if (Mode(elem.getIdx2()) == 0) return false;
+      // fall through
+      case 0:
+      case 1:
+        if (Mode(elem.getIdx1()) == 0) return false;
+        break;
+    }
+  }
+  return true;
+}
+
+bool FockState::apply(const DList &d) {
+  int nson = getDim() / 2;
+  if (nson > FOCK_MAX_MODES || !isNumeric(d)) return false;
+  for (int i = (int)d.size() - 1; i >= 0 && !amp.empty(); i--) {
+    const elemType &elem = d.at(i);
+    int k = Mode(elem.getIdx1());
+    switch (elem.getType()) {
+      case 0:
+        if (k < 1 || k > nson)
+          amp.clear();
+        else
+          annihilate(k);
+        break;
+      case 1:
+        if (k < 1 || k > nson)
+          amp.clear();
+        else
+          create(k);
+        break;
+      case 2:
+        if (k < 1 || k > nson || k != Mode(elem.getIdx2())) amp.clear();
+        break;
+    }
+  }
+  return true;
+}
+
+void FockState::add(const FockState &s, long long factor) {
+  for (map<Mask, long long>::const_iterator it = s.amp.begin(); it != s.amp.end(); ++it) {
+    long long &c = amp[it->first];
+    c += factor * it->second;
+    if (c == 0) amp.erase(it->first);
+  }
+}
+
+long long FockState::amplitude(Mask m) const {
+  map<Mask, long long>::const_iterator it = amp.find(m);
+  return it == amp.end() ? 0 : it->second;
+}
+
+}  // namespace sospin
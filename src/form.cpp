@@ -33,6 +33,7 @@
 //      Revision 1.1 28/02/2015 23:19:29 david
 //      License updated
 //      Revision 1.2 12/09/2023 16:53:51 david
+//      Revision 1.3 17/10/2026 FORM session
 
 /*!
   \file
@@ -41,8 +42,15 @@
 
 #include <sospin/dlist.h>
 #include <sospin/form.h>
+#include <sospin/formsession.h>
 #include <sospin/son.h>
+#include <sospin/stats.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>  // for stat()
+#include <unistd.h>
+
+#include <thread>
 
 using namespace std;
 
@@ -55,6 +63,7 @@ ToForm::ToForm(void) {
   formRenumber = false;
   resource_path = "";
   indexSum = true;
+  shards = 1;
 }
 
 ToForm::~ToForm() {
@@ -67,6 +76,7 @@ void ToForm::clear() {
   resource_path.clear();
   formRenumber = false;
   indexSum = true;
+  shards = 1;
   filename = "form";
 }
 
@@ -90,6 +100,14 @@ void ToForm::setRenumber(bool flag) {
     cout << "UnSetting \"renumber 1;\" in FORM" << endl;
 }
 
+void ToForm::setShards(int k) {
+  shards = k < 1 ? 1 : k;
+}
+
+int ToForm::getShards() {
+  return shards;
+}
+
 void ToForm::setFilename(string name) {
   filename = name;
 }
@@ -129,6 +147,21 @@ void unsetFormIndexSum() {
   form.setIndexSum(false);
 }
 
+/*! \brief Splits the expression in k batches simplified by k FORM processes running in parallel,
+    the k partial results are summed by a last FORM pass.
+
+    By default k is 1.
+*/
+void setFormShards(int k) {
+  form.setShards(k);
+}
+
+/*! \brief Runs one FORM process on the whole expression.
+ */
+void unsetFormShards() {
+  form.setShards(1);
+}
+
 /*! \brief Function to add field name and create field proprieties to FORM input file.
     \param[in] fieldname, name of the field
     \param[in] numUpperIds, number of upper indices
@@ -412,15 +445,14 @@ ToForm& ToForm::operator+(const string& func) {
 #define stringify(x) stringify_literal(x)
 #define stringify_literal(x) #x
 
-/*!
-  \brief Create file input for FORM and run the FORM program and return the result to file and/or screen
-  \param[in,out] exp Braket expression to be simplified in FORM, the result is written back
-  \param[in] print if @a TRUE prints final result to screen
-  \param[in] all if @a TRUE write all the expression members separately in ouput FORM file, if @ FALSE only writes the full result together.
-  \param[in] new indice label to be used when teh option to sum indices is active
-*/
-void Formrun(Braket& exp, ToForm& formin, bool print, bool all, string newidlabel) {
-  //    static bool setformpath = true;
+/*! \brief FORM session shared by every CallForm, see startFormSession() */
+static FormSession session;
+
+/*! \brief FORM result cache used by CallForm, see setFormCache() */
+static FormCache cache;
+
+/*! \brief Looks for the FORM binary (FORMDIR, current directory or PATH_TO_FORM) and stores it in formin.rpath() */
+static void FindForm(ToForm& formin) {
   if (formin.rpath().empty()) {
     const char* path;
     struct stat pstat;
@@ -462,9 +494,263 @@ void Formrun(Braket& exp, ToForm& formin, bool print, bool all, string newidlabe
     if (getVerbosity() > SUMMARIZE) cout << "Found form in: " << formin.rpath() << endl;
     //        setformpath = false;
   }
+}
+
+/*! \brief Writes the FORM statements that declare and simplify exp, up to the print statement
+  \param[out] fileout FORM program
+  \param[in] exp Braket expression
+  \param[in] formin FORM options
+  \param[in] all if @a TRUE prints all the expression members separately
+*/
+static void FormStatements(ostream& fileout, Braket& exp, ToForm& formin, bool all) {
+  fileout << "Dimension " + ToString<int>(getDim() / 2) + ";" << endl;
+  fileout << "format 255;" << endl;
+  fileout << "CFunction sqrt;" << endl;
+  fileout << "Symbols y,z;" << endl;
+  fileout << formin.getFunction() << "Indices " << IndexList() << endl;
+  fileout << "Off statistics;" << endl;
+  fileout << "*" << endl;
+  exp.writeForm(fileout);
+  fileout << "*" << endl;
+  fileout << "Local R =" << endl;
+  fileout << "          #do ii = 1, " + ToString<int>(exp.size()) << endl;
+  fileout << "                    + R`ii'" << endl;
+  fileout << "          #enddo" << endl;
+  fileout << ";" << endl;
+  fileout << "*" << endl;
+  fileout << "contract;" << endl;
+  fileout << "contract;" << endl;
+  fileout << "contract;" << endl;
+  fileout << "contract;" << endl;
+  fileout << "contract;" << endl;
+  fileout << "contract;" << endl;
+  fileout << "contract;" << endl;
+  fileout << "*\n"
+          << formin.getFC() << endl;
+  if (form.getIndexSum()) {
+    fileout << "sum " << IndexList() << endl;
+    fileout << "id e_(";
+    for (int i = 1; i <= getDim() / 2; i++) {
+      fileout << i;
+      if (i < getDim() / 2) fileout << ",";
+    }
+    fileout << ")=1;" << endl;
+  }
+  if (formin.getRenumberOption()) fileout << "renumber 1;" << endl;
+  //?????????????????????????????????????????????????????
+  // way to deal with 1/sqrt() in middle of expressions
+  fileout << "repeat;" << endl;
+  fileout << "  id 1/(sqrt(y?)) = sqrt(1/y);" << endl;
+  fileout << "  id sqrt(y?)*sqrt(z?) = sqrt(y*z);" << endl;
+  fileout << "endrepeat;" << endl;
+  //?????????????????????????????????????????????????????
+  if (all)
+    fileout << "print +s;" << endl;
+  else
+    fileout << "print R;" << endl;
+}
+
+/*! \brief Same as FormStatements, timed as PHASE_FORM_WRITE */
+static void FormProgram(ostream& fileout, Braket& exp, ToForm& formin, bool all) {
+  SOSPIN_PHASE(phase, PHASE_FORM_WRITE, exp.size());
+  SOSPIN_PHASE_OUT(phase, exp.size());
+  FormStatements(fileout, exp, formin, all);
+}
+
+FormOutput ParseFormOutput(const char* begin, const char* end, const string& newidlabel) {
+  SOSPIN_PHASE(phase, PHASE_FORM_PARSE, 0);
+  FormOutput out;
+  out.text.reserve(end - begin);
+  out.result = string::npos;
+  out.resultEnd = string::npos;
+  // 0: before "R =", 1: inside the result, 2: after the result
+  int state = 0;
+  int depth = 0;
+  string term;
+  vector<bool> seen;
+  const char* rawbegin = begin;
+  const char* p = begin;
+  while (p < end) {
+    char c = *p;
+    if (c == 'N') {
+      // dummy index N<digits>_?
+      const char* q = p + 1;
+      while (q < end && *q >= '0' && *q <= '9') q++;
+      if (q > p + 1 && q + 1 < end && q[0] == '_' && q[1] == '?') {
+        size_t k = 0;
+        for (const char* d = p + 1; d < q; d++) k = k * 10 + (*d - '0');
+        if (seen.size() <= k) seen.resize(k + 1, false);
+        seen[k] = true;
+        out.text += newidlabel;
+        out.text.append(p + 1, q);
+        if (state == 1) {
+          term += newidlabel;
+          term.append(p + 1, q);
+        }
+        p = q + 2;
+        continue;
+      }
+    }
+    out.text += c;
+    p++;
+    if (state == 0) {
+      size_t n = out.text.size();
+      if (n >= 3 && out.text.compare(n - 3, 3, "R =") == 0) {
+        out.result = n - 3;
+        rawbegin = p - 3;
+        state = 1;
+      }
+    } else if (state == 1) {
+      if (c == ';') {
+        if (!term.empty()) out.terms.push_back(term);
+        out.resultEnd = out.text.size();
+        out.raw.assign(rawbegin, p);
+        state = 2;
+      } else if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+        continue;
+      else {
+        if (c == '(') depth++;
+        if (c == ')') depth--;
+        // a sign at the top level starts a new term, unless it belongs to an exponent or a factor
+        if ((c == '+' || c == '-') && depth == 0 && !term.empty() && strchr("^*/,(", term[term.size() - 1]) == NULL) {
+          out.terms.push_back(term);
+          term.clear();
+        }
+        term += c;
+      }
+    }
+  }
+  // register the indices in increasing order, as FORM numbered them
+  for (size_t k = 0; k < seen.size(); k++)
+    if (seen[k]) newId(newidlabel + ToString<int>(k));
+  SOSPIN_PHASE_OUT(phase, out.terms.size());
+  return out;
+}
+
+/*! \brief Writes the result read by ParseFormOutput back in exp
+  \param[in] output FORM output read by ParseFormOutput
+  \param[in,out] exp Braket expression
+  \param[in] print if @a TRUE prints final result to screen
+  \param[in] where FORM output file or session, for the error message
+*/
+static void ReadFormResult(FormOutput& output, Braket& exp, bool print, const string& where) {
+  if (print) {
+    cout << "################################################################" << endl;
+    cout << "RESULTS FROM FORM: " << endl;
+  }
+  if (output.result == string::npos) {
+    cout << "Error, see FORM file for more details, " << where << endl;
+    exit(1);
+  }
+  if (print) cout << output.text.substr(output.result, output.resultEnd - output.result) << endl;
+  if (getVerbosity() == DEBUG_VERBOSE) cout << "Write the results in current expression..." << endl;
+  Braket newexp;
+  newexp.expfromForm(output.terms);
+  exp = newexp;
+  if (print) cout << "################################################################" << endl;
+}
+
+/*! \brief Largest numerator or denominator of the sum computed by SumRationals */
+static const long long RATIONAL_MAX = 1LL << 62;
+
+/*! \brief Sets r = a * b if |a * b| < RATIONAL_MAX, returns false otherwise */
+static bool MulRational(long long a, long long b, long long& r) {
+  unsigned long long ua = a < 0 ? 0ULL - (unsigned long long)a : (unsigned long long)a;
+  unsigned long long ub = b < 0 ? 0ULL - (unsigned long long)b : (unsigned long long)b;
+  if (ub != 0 && ua > (unsigned long long)(RATIONAL_MAX - 1) / ub) return false;
+  r = a * b;
+  return true;
+}
+
+/*! \brief Greatest common divisor of |a| and b > 0 */
+static long long GcdRational(long long a, long long b) {
+  if (a < 0) a = -a;
+  while (b) {
+    long long t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/*! \brief Sums exp without running FORM when every term is a rational number (see setNativeLeviCivita())
+  \return false if a term needs FORM
+*/
+static bool SumRationals(Braket& exp, bool print) {
+  long long n = 0, d = 1;
+  for (int i = 0; i < exp.size(); i++) {
+    BraketOneTerm& term = exp.Get(i);
+    long long tn, td;
+    if (!term.GetTerm().empty() || term.GetCoef().empty() || !term.GetCoef().rational(tn, td)) return false;
+    // n/d + tn/td over the denominator lcm(d, td), every step below RATIONAL_MAX
+    long long g = GcdRational(d, td), a, b;
+    if (!MulRational(n, td / g, a) || !MulRational(tn, d / g, b) || !MulRational(d, td / g, d)) return false;
+    n = a + b;
+    if (n >= RATIONAL_MAX || n <= -RATIONAL_MAX) return false;
+    g = GcdRational(n, d);
+    if (g > 1) {
+      n /= g;
+      d /= g;
+    }
+  }
+  string value = to_string(n);
+  if (d != 1) value += "/" + to_string(d);
+  FormOutput output;
+  output.text = "   R =\n      " + value + ";\n";
+  output.result = output.text.find("R =");
+  output.resultEnd = output.text.size() - 1;
+  output.terms.push_back(value);
+  output.raw = "R = " + value + ";";
+  if (getVerbosity() > SUMMARIZE) cout << "Expression summed without FORM" << endl;
+  ReadFormResult(output, exp, print, "SOSpin");
+  return true;
+}
+
+/*! \brief Same as Formrun, through the FORM session started by startFormSession()
+  \return the result as written by FORM, see FormOutput::raw
+*/
+static string FormrunSession(Braket& exp, ToForm& formin, bool print, bool all, string newidlabel) {
+  if (getVerbosity() > SUMMARIZE) cout << "Sending expression to the FORM session..." << endl;
+  Timer t1;
+  t1.start();
+  ostringstream job;
+  FormProgram(job, exp, formin, all);
+  job << ".sort" << endl;
+  job << "#toexternal \"R = %E;\\n\", R" << endl;
+  job << "#toexternal \"" << FormSession::endMark() << "\\n\"" << endl;
+  job << ".store" << endl;
+  string filecontent;
+  {
+    SOSPIN_PHASE(phase, PHASE_FORM_EXEC, 0);
+    session.send(job.str());
+    if (!session.receive(filecontent)) {
+      cout << "FORM session closed unexpectedly, see " << formin.file() << "_session.log" << endl;
+      session.stop();
+      exit(1);
+    }
+  }
+  FormOutput output = ParseFormOutput(filecontent.data(), filecontent.data() + filecontent.size(), newidlabel);
+  ReadFormResult(output, exp, print, formin.file() + "_session.log");
+  if (getVerbosity() > SUMMARIZE) cout << "Time FORM: " << t1.getElapsedTimeInMicroSec() << " us\t" << t1.getElapsedTimeInSec() << " s" << endl;
+  return output.raw;
+}
+
+/*! \brief Writes the FORM program simplifying exp in base_in.frm
+  \param[in] exp Braket expression to be simplified in FORM
+  \param[in] formin FORM options
+  \param[in] base beginning of the input/output FORM file names
+  \param[in] all if @a TRUE write all the expression members separately in ouput FORM file
+  \param[in] hash if @a TRUE the FORM program is hashed while it is written
+  \return FormCache::key() of the FORM program if hash is @a TRUE, otherwise an empty string
+*/
+static string WriteFormFile(Braket& exp, ToForm& formin, const string& base, bool all, bool hash = false) {
   if (getVerbosity() > SUMMARIZE) cout << "Creating input form file..." << endl;
-  string filenamein = formin.file() + "_in.frm";
-  ofstream fileout(filenamein.c_str());
+  string filenamein = base + "_in.frm";
+  string key;
+  vector<char> filebuf(1 << 20);
+  ofstream fileout;
+  fileout.rdbuf()->pubsetbuf(filebuf.data(), filebuf.size());
+  fileout.open(filenamein.c_str());
   if (fileout.is_open()) {
     fileout << "#-" << endl;
     fileout << "**********************************************************************" << endl;
@@ -475,53 +761,13 @@ void Formrun(Braket& exp, ToForm& formin, bool print, bool all, string newidlabe
     fileout << "**********************************************************************" << endl;
     fileout << "*" << endl;
     fileout << "*" << endl;
-    fileout << "Dimension " + ToString<int>(getDim() / 2) + ";" << endl;
-    fileout << "format 255;" << endl;
-    fileout << "CFunction sqrt;" << endl;
-    fileout << "Symbols y,z;" << endl;
-    fileout << formin.getFunction() << "Indices " << IndexList() << endl;
-    fileout << "Off statistics;" << endl;
-    fileout << "*" << endl;
-    exp.setON();
-    fileout << exp;
-    exp.setOFF();
-    fileout << "*" << endl;
-    fileout << "Local R =" << endl;
-    fileout << "          #do ii = 1, " + ToString<int>(exp.size()) << endl;
-    fileout << "                    + R`ii'" << endl;
-    fileout << "          #enddo" << endl;
-    fileout << ";" << endl;
-    fileout << "*" << endl;
-    fileout << "contract;" << endl;
-    fileout << "contract;" << endl;
-    fileout << "contract;" << endl;
-    fileout << "contract;" << endl;
-    fileout << "contract;" << endl;
-    fileout << "contract;" << endl;
-    fileout << "contract;" << endl;
-    fileout << "*\n"
-            << formin.getFC() << endl;
-    if (form.getIndexSum()) {
-      fileout << "sum " << IndexList() << endl;
-      fileout << "id e_(";
-      for (int i = 1; i <= getDim() / 2; i++) {
-        fileout << i;
-        if (i < getDim() / 2) fileout << ",";
-      }
-      fileout << ")=1;" << endl;
-    }
-    if (formin.getRenumberOption()) fileout << "renumber 1;" << endl;
-    //?????????????????????????????????????????????????????
-    // way to deal with 1/sqrt() in middle of expressions
-    fileout << "repeat;" << endl;
-    fileout << "  id 1/(sqrt(y?)) = sqrt(1/y);" << endl;
-    fileout << "  id sqrt(y?)*sqrt(z?) = sqrt(y*z);" << endl;
-    fileout << "endrepeat;" << endl;
-    //?????????????????????????????????????????????????????
-    if (all)
-      fileout << "print +s;" << endl;
-    else
-      fileout << "print R;" << endl;
+    if (hash) {
+      FormCache::Hasher hasher(fileout.rdbuf());
+      ostream program(&hasher);
+      FormProgram(program, exp, formin, all);
+      key = hasher.key();
+    } else
+      FormProgram(fileout, exp, formin, all);
     fileout << ".end" << endl;
   } else {
     cout << "Cannot create output file: " << filenamein << endl;
@@ -529,84 +775,176 @@ void Formrun(Braket& exp, ToForm& formin, bool print, bool all, string newidlabe
     exit(1);
   }
   fileout.close();
+  return key;
+}
+
+/*! \brief Runs FORM on base_in.frm and reads base_out.frm, written back with the indices renamed
+  \param[in] formin FORM options, with the FORM binary already found
+  \param[in] base beginning of the input/output FORM file names
+  \param[in] newidlabel indice label used for the FORM dummy indices
+  \return the FORM output read by ParseFormOutput
+*/
+static FormOutput RunFormFile(ToForm& formin, const string& base, const string& newidlabel) {
+  string filenamein = base + "_in.frm";
   if (getVerbosity() > SUMMARIZE) cout << "################################################################" << endl;
-  string filenameout = formin.file() + "_out.frm";
+  string filenameout = base + "_out.frm";
   if (getVerbosity() > SUMMARIZE) cout << "CALLING FORM..." << endl;
-  Timer t1;
-  t1.start();
   stringstream torun;
   torun << formin.rpath() << " " << filenamein << " > " << filenameout;
 
   if (getVerbosity() == DEBUG_VERBOSE) cout << "Running form: " << torun.str().c_str() << endl;
-  int out_system = system(torun.str().c_str());
+  int out_system;
+  {
+    SOSPIN_PHASE(phase, PHASE_FORM_EXEC, 0);
+    out_system = system(torun.str().c_str());
+  }
   if (getVerbosity() == DEBUG_VERBOSE && out_system != 0) cout << "System error during form execution: " << out_system << endl;
   if (getVerbosity() == DEBUG_VERBOSE) cout << "Read results form output form file..." << endl;
-  // Read results form output file
-  string line;
-  ifstream myfile(filenameout.c_str());
-  stringstream file;
-  if (myfile.is_open()) {
-    while (myfile.good()) {
-      getline(myfile, line);
-      file << line << endl;
-    }
-    myfile.close();
-  } else {
+  // Read results form output file, mapped in memory
+  int fd = open(filenameout.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
     cout << "Error reading output form file: " << filenameout << endl;
     exit(1);
   }
-  if (getVerbosity() == DEBUG_VERBOSE) cout << "Replacing form indices by j?..." << endl;
-  string filecontent = file.str();
-  // replace form indices by j_?
-  int i = 1;
-  while (true) {
-    string ind = "N" + ToString<int>(i) + "_?";
-    string idsub = newidlabel + ToString<int>(i);
-    if (filecontent.find(ind) == string::npos) break;
-    while (filecontent.find(ind) != string::npos) {
-      filecontent.replace(filecontent.find(ind), ind.size(), idsub);
-      newId(idsub);  // add this id...
+  const char* data = NULL;
+  void* map = MAP_FAILED;
+  if (st.st_size > 0) {
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      cout << "Error reading output form file: " << filenameout << endl;
+      exit(1);
     }
-    i++;
+    data = static_cast<const char*>(map);
   }
+  close(fd);
+  // replace form indices by j_? and split the result in terms
+  if (getVerbosity() == DEBUG_VERBOSE) cout << "Replacing form indices by j?..." << endl;
+  FormOutput output = ParseFormOutput(data, data + st.st_size, newidlabel);
+  if (map != MAP_FAILED) munmap(map, st.st_size);
   if (getVerbosity() == DEBUG_VERBOSE) cout << "Write back to output form file..." << endl;
   ofstream fileout0(filenameout.c_str());
   // write back to form output file with replaced indices
-  fileout0 << filecontent;
+  fileout0.write(output.text.data(), output.text.size());
   fileout0.close();
-  if (print) {
-    cout << "################################################################" << endl;
-    cout << "RESULTS FROM FORM: " << endl;
+  return output;
+}
+
+/*! \brief Splits exp in batches simplified by parallel FORM runs (files base_1, ..., base_k),
+    the partial results are summed by a last FORM run on base
+  \param[in] exp Braket expression to be simplified in FORM
+  \param[in] formin FORM options, with the FORM binary already found
+  \param[in] k number of batches
+  \param[in] all if @a TRUE write all the expression members separately in the output of the last FORM run
+  \param[in] newidlabel indice label used for the FORM dummy indices
+  \return the FORM output of the last run
+*/
+static FormOutput RunFormShards(Braket& exp, ToForm& formin, int k, bool all, const string& newidlabel) {
+  int n = exp.size();
+  vector<Braket> batches(k);
+  for (int s = 0; s < k; s++) batches[s] = exp.slice(s * n / k, (s + 1) * n / k);
+  // the input files are written first, the index table is not read while the outputs register new indices
+  for (int s = 0; s < k; s++) WriteFormFile(batches[s], formin, formin.file() + "_" + ToString<int>(s + 1), false);
+  vector<FormOutput> partial(k);
+  vector<thread> workers;
+  for (int s = 0; s < k; s++)
+    workers.push_back(thread([&, s]() { partial[s] = RunFormFile(formin, formin.file() + "_" + ToString<int>(s + 1), newidlabel); }));
+  for (int s = 0; s < k; s++) workers[s].join();
+  vector<string> terms;
+  for (int s = 0; s < k; s++) {
+    if (partial[s].result == string::npos) {
+      cout << "Error, see FORM file for more details, " << formin.file() << "_" << s + 1 << "_out.frm" << endl;
+      exit(1);
+    }
+    terms.insert(terms.end(), partial[s].terms.begin(), partial[s].terms.end());
   }
-  if (filecontent.find("R =") == string::npos) {
-    cout << "Error, see FORM file for more details, " << filenameout << endl;
-    exit(1);
+  Braket sum;
+  sum.expfromForm(terms);
+  WriteFormFile(sum, formin, formin.file(), all);
+  return RunFormFile(formin, formin.file(), newidlabel);
+}
+
+/*!
+  \brief Create file input for FORM and run the FORM program and return the result to file and/or screen
+  \param[in,out] exp Braket expression to be simplified in FORM, the result is written back
+  \param[in] print if @a TRUE prints final result to screen
+  \param[in] all if @a TRUE write all the expression members separately in ouput FORM file, if @ FALSE only writes the full result together.
+  \param[in] new indice label to be used when teh option to sum indices is active
+*/
+void Formrun(Braket& exp, ToForm& formin, bool print, bool all, string newidlabel) {
+  if (getNativeLeviCivita() && SumRationals(exp, print)) return;
+  string key;
+  int k = min(formin.getShards(), exp.size());
+  bool written = false;
+  if (cache.isOpen()) {
+    // the program holds the declarations, the index list, the contractions, the options and the expression,
+    // it is hashed while the FORM input file is written, or alone when no single input file is written
+    if (!session.isRunning() && k <= 1) {
+      key = WriteFormFile(exp, formin, formin.file(), all, true);
+      written = true;
+    } else {
+      FormCache::Hasher hasher;
+      ostream program(&hasher);
+      FormStatements(program, exp, formin, all);
+      key = hasher.key();
+    }
+    string cached;
+    if (cache.lookup(key, cached)) {
+      FormOutput output = ParseFormOutput(cached.data(), cached.data() + cached.size(), newidlabel);
+      ReadFormResult(output, exp, print, "FORM cache " + key);
+      return;
+    }
   }
-  filecontent.replace(0, filecontent.find("R ="), "");
-  filecontent.replace(filecontent.find(";") + 1, filecontent.length(), "");
-  // filecontent = "\tR = " +filecontent;
-  if (print) cout << filecontent << endl;
-  if (getVerbosity() == DEBUG_VERBOSE) cout << "Write the results in current expression..." << endl;
-  // NEED TO IMPLEMENT A BETTER WAY TO READ TO FORM AND CONVERT THE RESULT TO BRAKET.....
-  filecontent.erase(std::remove(filecontent.begin(), filecontent.end(), ' '), filecontent.end());
-  filecontent.erase(std::remove(filecontent.begin(), filecontent.end(), '\n'), filecontent.end());
-  filecontent = filecontent.substr(filecontent.find("R=") + 2, filecontent.find(';') - filecontent.find("R=") - 2);
-  vector<string> sta;
-  std::size_t found = filecontent.find_first_of("-+");
-  std::size_t found0 = 0;
-  while (found != std::string::npos) {
-    found = filecontent.find_first_of("+-", found0 + 1);
-    string tmp = filecontent.substr(found0, found - found0);
-    found0 = found;
-    if (!tmp.empty()) sta.push_back(tmp);
+  if (session.isRunning()) {
+    string raw = FormrunSession(exp, formin, print, all, newidlabel);
+    if (!key.empty()) cache.store(key, raw);
+    return;
   }
-  Braket newexp;
-  newexp.expfromForm(sta);
-  exp = newexp;
-  if (print) cout << "################################################################" << endl;
+  FindForm(formin);
+  Timer t1;
+  t1.start();
+  FormOutput output;
+  if (k > 1)
+    output = RunFormShards(exp, formin, k, all, newidlabel);
+  else {
+    if (!written) WriteFormFile(exp, formin, formin.file(), all);
+    output = RunFormFile(formin, formin.file(), newidlabel);
+  }
+  ReadFormResult(output, exp, print, formin.file() + "_out.frm");
+  if (!key.empty()) cache.store(key, output.raw);
   if (getVerbosity() > SUMMARIZE) cout << "Time FORM: " << t1.getElapsedTimeInMicroSec() << " us\t" << t1.getElapsedTimeInSec() << " s" << endl;
 }
 
+/*! \brief Starts the FORM session used by every following CallForm, instead of running FORM once per call.
+    \param[in] program FORM binary (or a program speaking the same protocol), found as in CallForm if empty
+*/
+void startFormSession(string program) {
+  if (program.empty()) {
+    FindForm(form);
+    program = form.rpath();
+  }
+  if (!session.start(program, form.file() + "_session.frm", form.file() + "_session.log")) {
+    cout << "Cannot start FORM session: " << program << endl;
+    exit(1);
+  }
+}
+
+void stopFormSession() { session.stop(); }
+
+void setFormCache(string dir, unsigned long long maxbytes) {
+  if (!cache.open(dir, maxbytes)) {
+    cout << "Cannot create FORM cache directory: " << dir << endl;
+    exit(1);
+  }
+  cache.evict();
+}
+
+void unsetFormCache() { cache.close(); }
+
+const FormCache& getFormCache() { return cache; }
+
+bool formSessionRunning() { return session.isRunning(); }
+
 void CallForm(Braket& exp, bool print, bool all, string newidlabel) {
   Formrun(exp, form, print, all, newidlabel);
 }
@@ -0,0 +1,178 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//       formcache.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief On-disk cache of FORM results, keyed by the FORM program.
+*/
+
+#include <sospin/formcache.h>
+#include <sospin/son.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <utime.h>
+
+namespace sospin {
+
+/*! \brief Extension of the cached files */
+static const char *FORM_CACHE_EXT = ".frc";
+
+FormCache::FormCache() : maxBytes(0), nhits(0), nmisses(0) {}
+
+string FormCache::path(const string &key) const { return directory + "/" + key + FORM_CACHE_EXT; }
+
+bool FormCache::open(const string &dir, unsigned long long maxbytes) {
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0 && mkdir(dir.c_str(), 0755) != 0) return false;
+  if (stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+  directory = dir;
+  maxBytes = maxbytes;
+  nhits = 0;
+  nmisses = 0;
+  return true;
+}
+
+void FormCache::close() { directory.clear(); }
+
+string FormCache::key(const string &program) {
+  Hasher hasher;
+  hasher.sputn(program.data(), program.size());
+  return hasher.key();
+}
+
+// FNV-1a with two offset bases, 128 bits with the length make collisions negligible
+FormCache::Hasher::Hasher(streambuf *next) : out(next), h0(14695981039346656037ULL), h1(0x6c62272e07bb0142ULL), length(0) {}
+
+FormCache::Hasher::int_type FormCache::Hasher::overflow(int_type c) {
+  if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+  char ch = traits_type::to_char_type(c);
+  return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+}
+
+streamsize FormCache::Hasher::xsputn(const char *s, streamsize n) {
+  for (streamsize i = 0; i < n; i++) {
+    unsigned char c = s[i];
+    h0 = (h0 ^ c) * 1099511628211ULL;
+    h1 = (h1 ^ c) * 1099511628211ULL;
+  }
+  length += n;
+  return out ? out->sputn(s, n) : n;
+}
+
+int FormCache::Hasher::sync() { return out ? out->pubsync() : 0; }
+
+string FormCache::Hasher::key() const {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%016llx%016llx_%llx", h0, h1, length);
+  return buf;
+}
+
+bool FormCache::lookup(const string &key, string &result) {
+  if (!isOpen()) return false;
+  ifstream in(path(key).c_str(), ios::binary);
+  if (!in.is_open()) {
+    nmisses++;
+    if (getVerbosity() > SUMMARIZE) cout << "FORM cache miss: " << key << endl;
+    return false;
+  }
+  ostringstream content;
+  content << in.rdbuf();
+  result = content.str();
+  in.close();
+  // the access time used by evict() is the modification time of the file
+  utime(path(key).c_str(), NULL);
+  nhits++;
+  if (getVerbosity() > SUMMARIZE) cout << "FORM cache hit: " << key << endl;
+  return true;
+}
+
+void FormCache::store(const string &key, const string &result) {
+  if (!isOpen()) return;
+  // written under another name and renamed, so a concurrent job never reads a partial file
+  ostringstream tmp;
+  tmp << path(key) << "." << getpid() << ".tmp";
+  {
+    ofstream out(tmp.str().c_str(), ios::binary);
+    if (!out.is_open()) {
+      if (getVerbosity() > SUMMARIZE) cout << "Cannot write FORM cache file: " << tmp.str() << endl;
+      return;
+    }
+    out.write(result.data(), result.size());
+  }
+  if (rename(tmp.str().c_str(), path(key).c_str()) != 0) {
+    remove(tmp.str().c_str());
+    return;
+  }
+  if (getVerbosity() == DEBUG_VERBOSE) cout << "FORM cache store: " << key << endl;
+  evict();
+}
+
+void FormCache::evict() {
+  if (!isOpen()) return;
+  DIR *dir = opendir(directory.c_str());
+  if (!dir) return;
+  // (modification time, size, file) of every cached file
+  vector<pair<pair<time_t, unsigned long long>, string> > files;
+  unsigned long long total = 0;
+  size_t extlen = string(FORM_CACHE_EXT).size();
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    string name = entry->d_name;
+    if (name.size() <= extlen || name.compare(name.size() - extlen, extlen, FORM_CACHE_EXT) != 0) continue;
+    string file = directory + "/" + name;
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) continue;
+    files.push_back(make_pair(make_pair(st.st_mtime, (unsigned long long)st.st_size), file));
+    total += st.st_size;
+  }
+  closedir(dir);
+  if (total <= maxBytes) return;
+  sort(files.begin(), files.end());
+  for (size_t i = 0; i < files.size() && total > maxBytes; i++) {
+    if (remove(files[i].second.c_str()) != 0) continue;
+    total -= files[i].first.second;
+    if (getVerbosity() > SUMMARIZE) cout << "FORM cache evict: " << files[i].second << endl;
+  }
+}
+
+}  // namespace sospin
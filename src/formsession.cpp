@@ -0,0 +1,215 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+//       formsession.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Persistent FORM process driven through FORM's external channel (-pipe).
+*/
+
+#include <sospin/formsession.h>
+#include <sospin/son.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace sospin {
+
+FormSession::FormSession() : pid(-1), towrite(-1), toread(-1) {}
+
+FormSession::~FormSession() { stop(); }
+
+string FormSession::initProgram() {
+  ostringstream out;
+  out << "#-" << endl;
+  out << "Off finalstats;" << endl;
+  // SOSPINLOOP is reset inside the loop, so it only ends when stop() sets SOSPINSTOP
+  out << "#define SOSPINSTOP \"0\"" << endl;
+  out << "#do SOSPINLOOP = 1, 1" << endl;
+  out << "  #fromexternal" << endl;
+  out << "  #if `SOSPINSTOP' == 0" << endl;
+  out << "    #redefine SOSPINLOOP \"0\"" << endl;
+  out << "  #endif" << endl;
+  out << "#enddo" << endl;
+  out << ".end" << endl;
+  return out.str();
+}
+
+bool FormSession::start(const string &program, const string &initfile, const string &logfile) {
+  stop();
+  {
+    ofstream init(initfile.c_str());
+    if (!init.is_open()) {
+      cout << "Cannot create FORM session file: " << initfile << endl;
+      return false;
+    }
+    init << initProgram();
+  }
+  int in[2], out[2];
+  if (pipe(in) != 0) return false;
+  if (pipe(out) != 0) {
+    close(in[0]);
+    close(in[1]);
+    return false;
+  }
+  pid = fork();
+  if (pid < 0) {
+    close(in[0]);
+    close(in[1]);
+    close(out[0]);
+    close(out[1]);
+    return false;
+  }
+  if (pid == 0) {
+    // FORM reads from in[0] and writes to out[1], its standard output goes to the log
+    close(in[1]);
+    close(out[0]);
+    int log = open(logfile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log >= 0) {
+      dup2(log, 1);
+      close(log);
+    }
+    ostringstream fds;
+    fds << in[0] << "," << out[1];
+    string sfds = fds.str();
+    execl(program.c_str(), program.c_str(), "-q", "-pipe", sfds.c_str(), initfile.c_str(), (char *)0);
+    _exit(127);
+  }
+  close(in[0]);
+  close(out[1]);
+  towrite = in[1];
+  toread = out[0];
+  pending.clear();
+  // handshake
+  string formpid;
+  if (!readLine(formpid) || formpid.empty()) {
+    cout << "FORM session: no handshake from " << program << endl;
+    stop();
+    return false;
+  }
+  ostringstream answer;
+  answer << formpid << "," << getpid() << endl << endl;
+  string s = answer.str();
+  if (write(towrite, s.data(), s.size()) != (ssize_t)s.size()) {
+    stop();
+    return false;
+  }
+  if (getVerbosity() > SUMMARIZE) cout << "Started FORM session, pid " << pid << endl;
+  return true;
+}
+
+bool FormSession::readLine(string &line) {
+  while (true) {
+    size_t end = pending.find('\n');
+    if (end != string::npos) {
+      line = pending.substr(0, end);
+      pending.erase(0, end + 1);
+      return true;
+    }
+    char buf[1 << 16];
+    ssize_t n = read(toread, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      line = pending;
+      pending.clear();
+      return false;
+    }
+    pending.append(buf, n);
+  }
+}
+
+void FormSession::send(const string &text) {
+  if (!isRunning()) {
+    cout << "FORM session is not running" << endl;
+    exit(1);
+  }
+  // the prompt (an empty line) ends the text, so empty lines inside it are dropped
+  string s;
+  s.reserve(text.size() + 2);
+  bool linestart = true;
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '\n' && linestart) continue;
+    s += text[i];
+    linestart = text[i] == '\n';
+  }
+  if (!linestart) s += '\n';
+  s += '\n';
+  size_t done = 0;
+  while (done < s.size()) {
+    ssize_t n = write(towrite, s.data() + done, s.size() - done);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      cout << "Error writing to the FORM session" << endl;
+      exit(1);
+    }
+    done += n;
+  }
+}
+
+bool FormSession::receive(string &out) {
+  out.clear();
+  string line;
+  while (readLine(line)) {
+    if (line == endMark()) return true;
+    out += line;
+    out += '\n';
+  }
+  out += line;
+  return false;
+}
+
+void FormSession::stop() {
+  if (pid <= 0) return;
+  // leave the #fromexternal loop of initProgram() and reach .end
+  string s = "#redefine SOSPINSTOP \"1\"\n\n";
+  if (write(towrite, s.data(), s.size()) < 0 && getVerbosity() == DEBUG_VERBOSE)
+    cout << "FORM session already closed" << endl;
+  close(towrite);
+  close(toread);
+  int status;
+  waitpid(pid, &status, 0);
+  pid = -1;
+  towrite = -1;
+  toread = -1;
+  pending.clear();
+}
+
+}  // namespace sospin
@@ -33,24 +33,113 @@
 //      Revision 1.1 28/02/2015 23:19:29 david
 //      License updated
 //      Revision 1.2 12/09/2023 16:53:51 david
+//      Revision 1.3 17/10/2026 hash table lookup of the indices
 
 /*!
   \file
   \brief Functions and cointainer for indexes.
 */
 
+#include <sospin/dlist.h>
 #include <sospin/index.h>
 
 #include <iostream>
+#include <mutex>
 
 using namespace std;
 
 namespace sospin {
 
 /*!
-\brief Vector container of the indexes
+\brief Vector container of the indexes, changed only by newIdx, newId and clearIdx
 */
-vector<string> tabids;
+static vector<string> idnames;
+const vector<string>& tabids = idnames;
+
+/*!
+\brief Open addressing hash table (linear probing) with the positions in tabids, -1 for an empty slot.
+The number of slots is a power of two and at least twice the number of indices.
+*/
+static vector<int> idslots;
+/*!
+\brief Hash of each index in tabids, kept to grow the table without hashing the names again
+*/
+static vector<size_t> idhashes;
+/*!
+\brief Numeric value of each index in tabids (as given by atoi), 0 for a symbolic index
+*/
+static vector<int> idvalues;
+/*!
+\brief Serializes the registration of new indices (newIdx, newId, clearIdx). Readers (getIdx, getIdxValue) do not lock
+and never write: new indices must not be added while other threads read the table, Braket::evaluate registers them before
+starting its threads.
+*/
+static mutex idmutex;
+
+/*!
+\brief FNV-1a hash of an index name
+*/
+static size_t hashIdx(const string& i) {
+  size_t h = 14695981039346656037ULL;
+  for (size_t j = 0; j < i.size(); j++) {
+    h ^= (unsigned char)i[j];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+/*!
+\brief Inserts position "pos" of tabids with hash "h" in the hash table
+*/
+static void slotIdx(size_t h, int pos) {
+  size_t mask = idslots.size() - 1;
+  size_t j = h & mask;
+  while (idslots[j] != -1) j = (j + 1) & mask;
+  idslots[j] = pos;
+}
+
+/*!
+\brief Rebuilds the hash table with "nslots" slots
+*/
+static void rehashIdx(size_t nslots) {
+  idslots.assign(nslots, -1);
+  for (size_t j = 0; j < tabids.size(); j++) slotIdx(idhashes[j], j);
+}
+
+/*!
+\brief Returns the position of index "i" in tabids, or -1 if it is not there
+*/
+static int findIdx(const string& i, size_t h) {
+  if (idslots.empty()) return -1;
+  size_t mask = idslots.size() - 1;
+  size_t j = h & mask;
+  while (idslots[j] != -1) {
+    int pos = idslots[j];
+    if (idhashes[pos] == h && tabids[pos] == i) return pos;
+    j = (j + 1) & mask;
+  }
+  return -1;
+}
+
+/*!
+\brief Append a new index with hash "h", stops if it no longer fits in the index fields of elemType
+\return position of the new index
+*/
+static int pushIdx(const string& i, size_t h) {
+  if (tabids.size() >= elemType::maxIndices()) {
+    cout << "Too many indices (" << tabids.size() + 1 << "), the maximum is " << elemType::maxIndices() << "." << endl;
+    cout << "Rebuild SOSpin with the CMake option SOSPIN_WIDE_ELEM=ON." << endl;
+    exit(1);
+  }
+  idnames.push_back(i);
+  idhashes.push_back(h);
+  idvalues.push_back(atoi(i.c_str()));
+  if (2 * tabids.size() + 2 > idslots.size())
+    rehashIdx(idslots.empty() ? 16 : 2 * idslots.size());
+  else
+    slotIdx(h, tabids.size() - 1);
+  return tabids.size() - 1;
+}
 
 ////////////////////////////////////////////////////
 
@@ -80,17 +169,10 @@ int newIdx(int i) {
   // tabids.push_back( ToString<int>(i) );
   // return tabids.size()-1;
   string addidx = ToString<int>(i);
-  int pos = -1;
-  for (size_t j = 0; j < tabids.size(); j++) {
-    if (addidx == tabids.at(j)) {
-      pos = j;
-      break;
-    }
-  }
-  if (pos == -1) {
-    tabids.push_back(addidx);
-    pos = tabids.size() - 1;
-  }
+  size_t h = hashIdx(addidx);
+  lock_guard<mutex> lock(idmutex);
+  int pos = findIdx(addidx, h);
+  if (pos == -1) pos = pushIdx(addidx, h);
   return pos;
 }
 
@@ -100,17 +182,10 @@ int newIdx(int i) {
 int newIdx(string i) {
   // tabids.push_back(i);
   // return tabids.size()-1;
-  int pos = -1;
-  for (size_t j = 0; j < tabids.size(); j++) {
-    if (i == tabids.at(j)) {
-      pos = j;
-      break;
-    }
-  }
-  if (pos == -1) {
-    tabids.push_back(i);
-    pos = tabids.size() - 1;
-  }
+  size_t h = hashIdx(i);
+  lock_guard<mutex> lock(idmutex);
+  int pos = findIdx(i, h);
+  if (pos == -1) pos = pushIdx(i, h);
   return pos;
 }
 
@@ -119,15 +194,9 @@ int newIdx(string i) {
 */
 void newId(string i) {
   // tabids.push_back(i);
-  int pos = -1;
-  for (size_t j = 0; j < tabids.size(); j++) {
-    if (i == tabids.at(j)) {
-      pos = j;
-      break;
-    }
-  }
-  if (pos == -1)
-    tabids.push_back(i);
+  size_t h = hashIdx(i);
+  lock_guard<mutex> lock(idmutex);
+  if (findIdx(i, h) == -1) pushIdx(i, h);
 }
 
 /*!
@@ -139,6 +208,26 @@ string getIdx(int i) {
   return tabids.at(i);
 }
 
+/*!
+\brief Get the numeric value of an index
+\param i position of the index
+\return value of the index in position @a i if it is a number, 0 if it is symbolic
+*/
+int getIdxValue(int i) {
+  return idvalues[i];
+}
+
+/*!
+\brief Removes all the indices
+*/
+void clearIdx() {
+  lock_guard<mutex> lock(idmutex);
+  idnames.clear();
+  idhashes.clear();
+  idvalues.clear();
+  idslots.clear();
+}
+
 /*!
 \brief Index list
 \return index list in string of the form "Indices ?,...,?";
@@ -33,10 +33,11 @@
 //      Revision 1.1 28/02/2015 23:19:29 david
 //      License updated
 //      Revision 1.2 12/09/2023 16:53:51 david
+//      Revision 1.3 17/10/2026 progress counters and reporter thread
 
 /*!
   \file
-  \brief Specific functions progress status bar.
+  \brief Progress of the library loops: counters updated by the loops and a reporter thread writing them to a sink.
 */
 
 #include <sospin/progressStatus.h>
@@ -44,17 +45,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 using namespace std;
 
 namespace sospin {
 
 #define PROGRESS_STATUS_BAR_LENGTH 46
 
-void DoProgress(string label, unsigned int step, unsigned int total, unsigned int interval) {
-
-  if (getVerbosity() == SILENT || total < 1) return;
+/*! \brief Serializes the output of the progress bar when evaluating with several threads */
+static mutex progressmutex;
 
-  if (step % interval != 0 && step < total) return;
+/*! \brief Prints "label  42% [====    ]" */
+static void PrintBar(const char* label, size_t step, size_t total) {
 
   // Calculuate the ratio of complete-to-incomplete.
 
@@ -64,7 +72,7 @@ void DoProgress(string label, unsigned int step, unsigned int total, unsigned in
 
   // Show the percentage completed.
 
-  printf("%s %3d%% [", label.c_str(), (int)(ratio * 100));
+  printf("%s %3d%% [", label, (int)(ratio * 100));
 
   // Show the loading bar.
 
@@ -73,6 +81,17 @@ void DoProgress(string label, unsigned int step, unsigned int total, unsigned in
   for (int x = c; x < PROGRESS_STATUS_BAR_LENGTH; x++) printf(" ");
 
   printf("]\n");
+}
+
+void DoProgress(string label, unsigned int step, unsigned int total, unsigned int interval) {
+
+  if (getVerbosity() == SILENT || total < 1) return;
+
+  if (step % interval != 0 && step < total) return;
+
+  lock_guard<mutex> lock(progressmutex);
+
+  PrintBar(label.c_str(), step, total);
 
   // ANSI Control codes to go back to the previous line and clear it.
 
@@ -95,6 +114,146 @@ void DoProgress(string label, unsigned int step, unsigned int total) {
   DoProgress(label, step, total, 10);
 }
 
+void TerminalProgress::report(const char* label, size_t step, size_t total) {
+  PrintBar(label, step, total);
+  // ANSI Control codes to go back to the previous line and clear it.
+  printf("\033[F\033[J");
+  fflush(stdout);
+}
+
+void TerminalProgress::finish(const char* label, size_t total) {
+  PrintBar(label, total, total);
+  if (getVerbosity() < VERBOSE) printf("\033[F\033[J");
+  fflush(stdout);
+}
+
+void LogProgress::report(const char* label, size_t step, size_t total) {
+  out << label << " " << (int)(100.0 * step / total) << "% (" << step << "/" << total << ")" << endl;
+}
+
+void LogProgress::finish(const char* label, size_t total) { report(label, total, total); }
+
+/*!
+  \brief Thread writing the progress of the running loops to the sink every setProgressInterval() milliseconds.
+  Started by the first loop reported, it sleeps while no loop runs.
+*/
+class ProgressReporter {
+ public:
+  ProgressReporter() : sink(make_shared<TerminalProgress>()), interval(PROGRESS_INTERVAL), stopping(false), last(0), lastStep(0), finished(0) {}
+  ~ProgressReporter() {
+    {
+      lock_guard<mutex> lock(m);
+      stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+  }
+  /*! \brief Starts reporting p, returns false if there is no sink */
+  bool begin(Progress* p) {
+    lock_guard<mutex> lock(m);
+    if (!sink) return false;
+    active.push_back(p);
+    if (!worker.joinable()) worker = thread(&ProgressReporter::run, this);
+    wake.notify_all();
+    return true;
+  }
+  /*! \brief Stops reporting p and writes its end */
+  void end(Progress* p) {
+    shared_ptr<ProgressSink> s;
+    {
+      lock_guard<mutex> lock(m);
+      active.erase(find(active.begin(), active.end(), p));
+      if (last == p) last = 0;
+      finished++;
+      s = sink;
+    }
+    // the sink is called without m, it may set or get the sink or the interval
+    lock_guard<recursive_mutex> order(calls);
+    if (s) s->finish(p->label(), p->total());
+  }
+  shared_ptr<ProgressSink> sink;
+  unsigned int interval;
+  mutex m;
+
+ private:
+  void run() {
+    unique_lock<mutex> lock(m);
+    while (!stopping) {
+      if (active.empty()) {
+        wake.wait(lock);
+        continue;
+      }
+      wake.wait_for(lock, chrono::milliseconds(interval));
+      if (stopping || active.empty() || !sink) continue;
+      // the innermost loop
+      Progress* p = active.back();
+      size_t step = p->step();
+      if (p == last && step == lastStep) continue;
+      shared_ptr<ProgressSink> s = sink;
+      const char* label = p->label();
+      size_t total = p->total();
+      unsigned long ended = finished;
+      lock.unlock();
+      {
+        // skip the report if a loop ended meanwhile, its finish() must stay the last call
+        lock_guard<recursive_mutex> order(calls);
+        bool current;
+        {
+          lock_guard<mutex> check(m);
+          current = finished == ended;
+          if (current) {
+            last = p;
+            lastStep = step;
+          }
+        }
+        if (current) s->report(label, step, total);
+      }
+      lock.lock();
+    }
+  }
+  condition_variable wake;
+  thread worker;
+  bool stopping;
+  /*! \brief Loops running, the innermost last */
+  vector<Progress*> active;
+  /*! \brief Loop and step of the last report */
+  Progress* last;
+  size_t lastStep;
+  /*! \brief Number of loops ended */
+  unsigned long finished;
+  /*! \brief Held while the sink is called, taken before m: the reports and ends reach the sink in order.
+      Recursive, a sink may run a Progress loop of its own */
+  recursive_mutex calls;
+};
+
+static ProgressReporter& Reporter() {
+  static ProgressReporter reporter;
+  return reporter;
+}
+
+void setProgressSink(shared_ptr<ProgressSink> sink) {
+  lock_guard<mutex> lock(Reporter().m);
+  Reporter().sink = sink;
+}
+
+shared_ptr<ProgressSink> getProgressSink() {
+  lock_guard<mutex> lock(Reporter().m);
+  return Reporter().sink;
+}
+
+void setProgressInterval(unsigned int milliseconds) {
+  lock_guard<mutex> lock(Reporter().m);
+  Reporter().interval = milliseconds > 0 ? milliseconds : 1;
+}
+
+Progress::Progress(const char* label, size_t total) : name(label), count(total), current(0), reported(false) {
+  if (getVerbosity() != SILENT && total > 0) reported = Reporter().begin(this);
+}
+
+Progress::~Progress() {
+  if (reported) Reporter().end(this);
+}
+
 #ifdef PROGRESS_STATUS_BAR_LENGTH
 
 #undef PROGRESS_STATUS_BAR_LENGTH
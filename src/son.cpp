@@ -46,6 +46,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
 using namespace std;
 
@@ -53,6 +54,8 @@ namespace sospin {
 
 static int GroupDim = 10;  // default value
 static Verbosity verbose_flag = SUMMARIZE;
+static int NumThreads = 1;  // default value
+static bool FlagImplicitBop = false;
 
 void setDim(int n) {
   GroupDim = n;
@@ -71,7 +74,7 @@ bool GroupEven() {
 
 void CleanGlobalDecl() {
   form.clear();
-  tabids.clear();
+  clearIdx();
 }
 
 void setVerbosity(Verbosity verb) {
@@ -82,6 +85,20 @@ Verbosity getVerbosity() {
   return verbose_flag;
 }
 
+void setThreads(int n) {
+  if (n <= 0) n = thread::hardware_concurrency();
+  if (n <= 0) n = 1;
+  NumThreads = n;
+}
+
+int getThreads() {
+  return NumThreads;
+}
+
+void setImplicitBop() { FlagImplicitBop = true; }
+
+void unsetImplicitBop() { FlagImplicitBop = false; }
+
 /*!\brief Operator B, "charge conjugation" matrix for SO(2N) spinor representations
 
   \param startid the algebraic indexes are written as startid_? (optional, default startid="i")
@@ -94,31 +111,24 @@ Verbosity getVerbosity() {
 
 */
 Braket Bop(string startid) {
-  Braket b0, b1;
-  b0 = bb(startid + "1");
-  b0 -= bbt(startid + "1");
-  string constpart0 = "*e_(" + startid + "1";
-  string constpart;
-  if ((getDim() / 2) % 2 == 0)
-    constpart = "1/";
-  else
-    constpart = "i_/";
+  int n = getDim() / 2;
+  vector<int> ids;
+  string constpart0 = "*e_(";
   int factorn = 1;
-  for (int i = 2; i <= getDim() / 2; i++) {
+  for (int i = 1; i <= n; i++) {
     string idx = startid + ToString<int>(i);
-    b1 = bb(idx);
-    b1 -= bbt(idx);
-    b0 = b0 * b1;
-    constpart0 += ",";
+    ids.push_back(newIdx(idx));
+    if (i > 1) constpart0 += ",";
     constpart0 += idx;
     factorn *= i;
   }
-  constpart += ToString<int>(factorn) + constpart0 + ")";
-  if ((getDim() / 2) % 4 == 0 || (getDim() / 2) % 4 == 3)
-    b0 = b0 * constpart;
+  string constpart;
+  if (n % 2 == 0)
+    constpart = "1/";
   else
-    b0 = -b0 * constpart;
-  return b0;
+    constpart = "i_/";
+  constpart += ToString<int>(factorn) + constpart0 + ")";
+  return Braket::bProduct(ids, constpart, !(n % 4 == 0 || n % 4 == 3), FlagImplicitBop);
 }
 
 /*!\brief Operator B, charge conjugation matrix for SO(2N) spinor representations
@@ -132,24 +142,15 @@ Braket Bop(string startid) {
 */
 
 Braket BopIdnum() {
-  Braket b0, b1;
-  b0 = bb(1);
-  b0 -= bbt(1);
-  for (int i = 2; i <= getDim() / 2; i++) {
-    b1 = bb(i);
-    b1 -= bbt(i);
-    b0 = b0 * b1;
-  }
+  int n = getDim() / 2;
+  vector<int> ids;
+  for (int i = 1; i <= n; i++) ids.push_back(newIdx(i));
   string constpart;
-  if ((getDim() / 2) % 2 == 0)
+  if (n % 2 == 0)
     constpart = "1";
   else
     constpart = "i_";
-  if ((getDim() / 2) % 4 == 0 || (getDim() / 2) % 4 == 3)
-    b0 = b0 * constpart;
-  else
-    b0 = -b0 * constpart;
-  return b0;
+  return Braket::bProduct(ids, constpart, !(n % 4 == 0 || n % 4 == 3), FlagImplicitBop);
 }
 
 ostream& operator<<(ostream& out, const Verbosity& a) {
@@ -0,0 +1,150 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+//       stats.cpp created on 17/10/2026
+//
+//      This file is an integrant part of the SOSpin Library.
+
+/*!
+  \file
+  \brief Call counts, times and term counts of the library phases (rearrange, simplify, evaluation, FORM).
+*/
+
+#include <sospin/son.h>
+#include <sospin/stats.h>
+
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+
+namespace sospin {
+
+/*! \brief Names of the phases, in the order of Phase */
+static const char *PhaseNames[PHASE_COUNT] = {"rearrange",
+                                              "checkindex",
+                                              "simplify",
+                                              "EvaluateToDeltas",
+                                              "ReduceNumberOfBandBdaggers",
+                                              "OrderBandBdaggers",
+                                              "EvaluateEps_2ndPass",
+                                              "EvaluateFock",
+                                              "form_write",
+                                              "form_exec",
+                                              "form_parse"};
+
+/*! \brief Counters of one phase, times in nanoseconds */
+struct PhaseCounters {
+  atomic<unsigned long long> calls;
+  atomic<long long> wall;
+  atomic<long long> cpu;
+  atomic<unsigned long long> termsIn;
+  atomic<unsigned long long> termsOut;
+};
+
+static PhaseCounters Counters[PHASE_COUNT];
+
+/*! \brief Monotonic wall clock, in nanoseconds */
+static inline long long WallNow() {
+  return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*! \brief CPU time of the calling thread, in nanoseconds */
+static inline long long CpuNow() {
+#ifdef WIN32
+  return (long long)clock() * (1000000000LL / CLOCKS_PER_SEC);
+#else
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+PhaseScope::PhaseScope(Phase p, size_t termsIn) : phase(p), termsOut(0) {
+  Counters[phase].termsIn.fetch_add(termsIn, memory_order_relaxed);
+  wallStart = WallNow();
+  cpuStart = CpuNow();
+}
+
+PhaseScope::~PhaseScope() {
+  PhaseCounters &c = Counters[phase];
+  c.cpu.fetch_add(CpuNow() - cpuStart, memory_order_relaxed);
+  c.wall.fetch_add(WallNow() - wallStart, memory_order_relaxed);
+  c.calls.fetch_add(1, memory_order_relaxed);
+  c.termsOut.fetch_add(termsOut, memory_order_relaxed);
+}
+
+vector<PhaseStats> getPhaseStats() {
+  vector<PhaseStats> out(PHASE_COUNT);
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    out[i].name = PhaseNames[i];
+    out[i].calls = Counters[i].calls;
+    out[i].wall = Counters[i].wall * 1e-9;
+    out[i].cpu = Counters[i].cpu * 1e-9;
+    out[i].termsIn = Counters[i].termsIn;
+    out[i].termsOut = Counters[i].termsOut;
+  }
+  return out;
+}
+
+void resetStats() {
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    Counters[i].calls = 0;
+    Counters[i].wall = 0;
+    Counters[i].cpu = 0;
+    Counters[i].termsIn = 0;
+    Counters[i].termsOut = 0;
+  }
+}
+
+string stats() {
+  vector<PhaseStats> phases = getPhaseStats();
+  ostringstream out;
+#ifdef SOSPIN_STATS
+  out << "{\"enabled\": true";
+#else
+  out << "{\"enabled\": false";
+#endif
+  out << ", \"peak_rss_bytes\": " << getPeakRSS() << ", \"phases\": [";
+  for (size_t i = 0; i < phases.size(); i++) {
+    const PhaseStats &p = phases[i];
+    out << (i ? ",\n  " : "\n  ") << "{\"name\": \"" << p.name << "\", \"calls\": " << p.calls << ", \"wall_s\": " << p.wall
+        << ", \"cpu_s\": " << p.cpu << ", \"terms_in\": " << p.termsIn << ", \"terms_out\": " << p.termsOut
+        << ", \"blowup\": ";
+    if (p.termsIn > 0)
+      out << (double)p.termsOut / p.termsIn;
+    else
+      out << "null";
+    out << "}";
+  }
+  out << "]}";
+  return out.str();
+}
+
+}  // namespace sospin
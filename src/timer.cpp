@@ -38,8 +38,8 @@ Timer::Timer() {
   startCount.QuadPart = 0;
   endCount.QuadPart = 0;
 #else
-  startCount.tv_sec = startCount.tv_usec = 0;
-  endCount.tv_sec = endCount.tv_usec = 0;
+  startCount.tv_sec = startCount.tv_nsec = 0;
+  endCount.tv_sec = endCount.tv_nsec = 0;
 #endif
 
   stopped = 0;
@@ -57,7 +57,7 @@ void Timer::start() {
 #ifdef WIN32
   QueryPerformanceCounter(&startCount);
 #else
-  gettimeofday(&startCount, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &startCount);
 #endif
 }
 
@@ -68,7 +68,7 @@ void Timer::stop() {
 #ifdef WIN32
   QueryPerformanceCounter(&endCount);
 #else
-  gettimeofday(&endCount, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &endCount);
 #endif
 }
 
@@ -82,10 +82,10 @@ double Timer::getElapsedTimeInMicroSec() {
   endTimeInMicroSec = endCount.QuadPart * (1000000.0 / frequency.QuadPart);
 #else
   if (!stopped)
-    gettimeofday(&endCount, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &endCount);
 
-  startTimeInMicroSec = (startCount.tv_sec * 1000000.0) + startCount.tv_usec;
-  endTimeInMicroSec = (endCount.tv_sec * 1000000.0) + endCount.tv_usec;
+  startTimeInMicroSec = (startCount.tv_sec * 1000000.0) + startCount.tv_nsec * 0.001;
+  endTimeInMicroSec = (endCount.tv_sec * 1000000.0) + endCount.tv_nsec * 0.001;
 #endif
 
   return endTimeInMicroSec - startTimeInMicroSec;
@@ -43,105 +43,223 @@
 #include <sospin/son.h>
 #include <sospin/tools/so10.h>
 
+#include <cctype>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
 using namespace std;
 
 namespace sospin {
 
-/*!\brief Gamma's
+/*!
+  \brief Expression built once by a SO(10) constructor and shared by the following calls
+*/
+struct So10Template {
+  /*! \brief Expression, its DLists refer to the positions in pos */
+  Braket exp;
+  /*! \brief Indices used by the expression (DLists and constant parts), in order of registration */
+  vector<string> names;
+  /*! \brief Position of each index of names in the index table when the expression was built */
+  vector<int> pos;
+  /*! \brief Index head of the psi_*(mode, id) constructors, empty otherwise */
+  string prefix;
+};
+
+/*! \brief Templates by "dimension:constructor:mode[:id]" */
+static map<string, shared_ptr<const So10Template> > templates;
+/*! \brief One template of each psi_*(mode, id) constructor and mode, relabelled for the other index heads */
+static map<string, shared_ptr<const So10Template> > families;
+
+/*! \brief Adds the dimension to the key of a template */
+static string TemplateKey(const string& key) { return ToString<int>(getDim()) + ":" + key; }
+
+/*! \brief Returns a copy of exp with the index positions of its DLists changed by remap */
+static Braket RemapIndices(const Braket& exp, const unordered_map<int, int>& remap) {
+  Braket out = exp;
+  for (int i = 0; i < out.size(); i++) {
+    list<DList>& term = out.Get(i).GetTerm();
+    for (list<DList>::iterator iter = term.begin(); iter != term.end(); iter++) {
+      DList d;
+      for (unsigned int k = 0; k < iter->size(); k++) {
+        elemType elem = iter->at(k);
+        // b, b^\dagger and delta elements carry indices
+        if (elem.getType() <= 2) {
+          unordered_map<int, int>::const_iterator it = remap.find(elem.getIdx1());
+          if (it != remap.end()) elem.setIdx1(it->second);
+          if (elem.getType() == 2) {
+            it = remap.find(elem.getIdx2());
+            if (it != remap.end()) elem.setIdx2(it->second);
+          }
+        }
+        d << elem;
+      }
+      d.set_sign(iter->getSign());
+      *iter = d;
+    }
+  }
+  return out;
+}
 
-  GammaH(n):
-  n=0:
-  \f{eqnarray*}{
-  \Gamma_\mu \phi_\mu &=& H
-  \f}
+/*! \brief Calls f on each identifier of the constant part c, with its position and length */
+template <class F>
+static void ForEachIdentifier(const string& c, F f) {
+  size_t i = 0;
+  while (i < c.size()) {
+    if (isalpha((unsigned char)c[i]) || c[i] == '_') {
+      size_t j = i + 1;
+      while (j < c.size() && (isalnum((unsigned char)c[j]) || c[j] == '_')) j++;
+      f(i, j - i);
+      i = j;
+    } else
+      i++;
+  }
+}
 
-  n=1:
-  \f{eqnarray*}{
-  \Gamma_\mu \phi_\mu &=& \sqrt{2}\left(b_{r_1} H_{r_1} +  b^\dagger_{r_2} H^{r_2}  \right) \quad\quad (normalized)
-  \f}
+/*! \brief Keeps exp as the template of key, the indices it uses are looked up in the index table
+  \param[in] key constructor, mode and index head
+  \param[in] exp expression just built by the constructor
+  \param[in] prefix index head of the psi_*(mode, id) constructors
+  \param[in] family key of the psi_*(mode, id) constructor and mode, empty for the other constructors
+  \return exp
+*/
+static Braket MakeTemplate(const string& key, Braket exp, const string& prefix = "", const string& family = "") {
+  shared_ptr<So10Template> t = make_shared<So10Template>();
+  unordered_map<string, int> table;
+  for (size_t i = 0; i < tabids.size(); i++) table.insert(make_pair(tabids[i], (int)i));
+  set<int> used;
+  for (int i = 0; i < exp.size(); i++) {
+    BraketOneTerm& term = exp.Get(i);
+    const string& c = term.GetConst();
+    ForEachIdentifier(c, [&](size_t b, size_t n) {
+      unordered_map<string, int>::const_iterator it = table.find(c.substr(b, n));
+      if (it != table.end()) used.insert(it->second);
+    });
+    for (list<DList>::iterator iter = term.GetTerm().begin(); iter != term.GetTerm().end(); iter++)
+      for (unsigned int k = 0; k < iter->size(); k++) {
+        const elemType& elem = iter->at(k);
+        if (elem.getType() <= 2) used.insert(elem.getIdx1());
+        if (elem.getType() == 2) used.insert(elem.getIdx2());
+      }
+  }
+  for (set<int>::iterator it = used.begin(); it != used.end(); it++) {
+    t->names.push_back(getIdx(*it));
+    t->pos.push_back(*it);
+  }
+  t->exp = exp;
+  t->prefix = prefix;
+  templates[TemplateKey(key)] = t;
+  if (!family.empty()) families[TemplateKey(family)] = t;
+  return exp;
+}
 
-  n=2:
-  \f{eqnarray*}{
-  \Gamma_\mu\Gamma_\nu \phi_{\mu\nu} &=& -i \frac{\sqrt{2}}{2} H_{r_1,r_2} b_{r_1} b_{r_2}
-                                      -i \frac{\sqrt{2}}{2} H^{r_1,r_2} b^\dagger_{r_1} b^\dagger_{r_2}
-                                      -i \left(\sqrt{2} H^{r_1}_{r_2} + \frac{\sqrt{10}}{5} \delta_{r1,r2} H\right) b^\dagger_{r_1} b_{r_2}
-                                      +\frac{\sqrt{10}}{2} H  \quad\quad (normalized)
-  \f}
+/*! \brief Returns in out the expression of template t, registering its indices.
+    If the index table changed since t was built (e.g. CleanGlobalDecl), the DLists are relabelled
+    and t is replaced in the cache by the relabelled template.
+*/
+static void Instantiate(const string& key, shared_ptr<const So10Template> t, Braket& out) {
+  vector<int> now(t->names.size());
+  bool same = true;
+  for (size_t i = 0; i < t->names.size(); i++) {
+    now[i] = newIdx(t->names[i]);
+    if (now[i] != t->pos[i]) same = false;
+  }
+  if (same) {
+    out = t->exp;
+    return;
+  }
+  unordered_map<int, int> remap;
+  for (size_t i = 0; i < now.size(); i++) remap[t->pos[i]] = now[i];
+  shared_ptr<So10Template> r = make_shared<So10Template>(*t);
+  r->exp = RemapIndices(t->exp, remap);
+  r->pos = now;
+  templates[TemplateKey(key)] = r;
+  out = r->exp;
+}
 
-  n=3:
-  \f{eqnarray*}{
-  \Gamma_\mu\Gamma_\nu\Gamma_\gamma \phi_{\mu\nu\gamma} &=&   \frac{1}{6\sqrt{3}} \varepsilon_{r1,r2,r3,r4,r5} \left( H^{r_4,r_5} b_{r_1} b_{r_2} b_{r_3} +  H_{r_4,r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3}\right)\\
-&& + \frac{1}{2\sqrt{3}} \left(2 H^{r_1}_{r_2,r_3} +  \delta_{r_1,r_2} H_{r_3} - \delta_{r_1,r_3} H_{r_2}\right)
-b^\dagger_{r_1} b_{r_2} b_{r_3}\\
-&& + \frac{1}{2\sqrt{3}} \left(2 H^{r_1,r_2}_{r_3} +  \delta_{r_1,r_3} H^{r_2} - \delta_{r_2,r_3} H^{r_1}\right)
-b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3}\\
-&&+\frac{2}{\sqrt{3}} \left(H^{r_1} b^\dagger_{r_1} - H_{r_1} b_{r_1}\right)
-   \quad\quad (normalized)
-  \f}
-  n=4:
-  \f{eqnarray*}{
-  \Gamma_\mu\Gamma_\nu\Gamma_\gamma \Gamma_\rho \phi_{\mu\nu\gamma\rho} &=&   \frac{1}{3\sqrt{2}} \left(\frac{1}{\sqrt{3}} H^{r_1,r_2,r_3}_{r_4} + \frac{1}{3}\left(\delta_{r_3,r_4} H^{r_1,r_2} - \delta_{r_2,r_4} H^{r_1,r_3} + \delta_{r_1,r_4} H^{r_2,r_3}\right)\right) b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b_{r_4}\\
-   &&-\frac{1}{3\sqrt{2}}\left(\frac{1}{\sqrt{3}}H^{r_1}_{r_2,r_3,r_4} + \frac{1}{3} \left(\delta_{r_1,r_4} H_{r_2,r_3} - \delta_{r_1,r_3} H_{r_2,r_4} + \delta_{r_1,r_2} H_{r_3,r_4}\right)\right) b^\dagger_{r_1} b_{r_2} b_{r_3} b_{r_4}\\
-   && +\frac{1}{12\sqrt{6}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H_{r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_4} + \frac{1}{12\sqrt{6}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H^{r_5} b_{r_1} b_{r_2} b_{r_3} b_{r_4}\\
-  &&-\frac{\sqrt{2}}{4} H^{r_1,r_2} b^\dagger_{r_1} b^\dagger_{r_2} +\frac{\sqrt{2}}{4} H_{r_1,r_2} b_{r_1} b_{r_2}\\
-  &&+\frac{\sqrt{5}}{2\sqrt{3}} H -\left(\frac{\sqrt{2}}{2} H^{r_1}_{r_2} +\frac{2\sqrt{5}}{5\sqrt{3}} \delta_{r_1,r_2} H\right) b^\dagger_{r_1} b_{r_2} \\
-  &&+\frac{1}{4}\left(\sqrt{\frac{2}{3}} H^{r_1,r_2}_{r_3,r_4} + \frac{\sqrt{2}}{3} \left(\delta_{r_1,r_4} H^{r_2}_{r_3} - \delta_{r_1,r_3} H^{r_2}_{r_4} + \delta_{r_2,r3} H^{r_1}_{r_4} - \delta_{r_2,r_4} H^{r_1}_{r_3} \right)
-  + \frac{\sqrt{5}}{5\sqrt{3}} \left(\delta_{r_1,r_4}  \delta_{r_2,r_3} - \delta_{r_1,r_3}  \delta_{r_2,r_4}\right) H \right)
-  b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3} b_{r_4}
-   \quad\quad (normalized)
-  \f}
+/*! \brief Looks key up in the templates
+  \param[in] key constructor, mode and index head
+  \param[out] out expression of the template
+  \return false if key was not built yet
+*/
+static bool UseTemplate(const string& key, Braket& out) {
+  map<string, shared_ptr<const So10Template> >::iterator it = templates.find(TemplateKey(key));
+  if (it == templates.end()) return false;
+  Instantiate(key, it->second, out);
+  return true;
+}
 
-  n=5:
-  \f{eqnarray*}{
-  \Gamma_\mu\Gamma_\nu\Gamma_\gamma \Gamma_\rho \Gamma_\eta \phi_{\mu\nu\gamma\rho\eta} &=&   +\frac{\sqrt{15}}{60} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H b_{r_1} b_{r_2} b_{r_3} b_{r_4} b_{r_5}
-      +\frac{\sqrt{15}}{60} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_4} b^\dagger_{r_5}\\
-   &&   +\frac{\sqrt{2}}{2\sqrt{5}} H^{r_1} b^\dagger_{r_1}
-      -\frac{2\sqrt{2}}{3\sqrt{5}} H^{r_1}  b^\dagger_{r_1} b^\dagger_{r_n} b_{r_n}
-      +\frac{\sqrt{2}}{6\sqrt{5}}  H^{r_1} b^\dagger_{r_1} b^\dagger_{r_n} b_{r_n} b^\dagger_{r_m} b_{r_m}\\
-   &&   +\frac{\sqrt{2}}{2\sqrt{5}} H_{r_1}  b_{r_1}
-      -\frac{2\sqrt{2}}{3\sqrt{5}} H_{r_1} b^\dagger_{r_n} b_{r_n} b_{r_1}
-      +\frac{\sqrt{2}}{6\sqrt{5}} H_{r_1} b^\dagger_{r_n} b_{r_n} b^\dagger_{r_m} b_{r_m} b_{r_1}\\
-   &&   +\frac{\sqrt{2}}{12\sqrt{15}}  \varepsilon_{r_1,r_2,r_3,r_4,r_5} H_{r_4,r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3}
-      -\frac{\sqrt{2}}{12\sqrt{15}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H_{r_4,r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_n} b_{r_n}\\
-   &&   +\frac{\sqrt{2}}{12\sqrt{15}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H^{r_4,r_5} b_{r_1} b_{r_2} b_{r_3}
-      -\frac{\sqrt{2}}{12\sqrt{15}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H^{r_4,r_5} b^\dagger_{r_n} b_{r_n} b_{r_1} b_{r_2} b_{r_3} \\
-   &&   +\frac{\sqrt{2}}{\sqrt{15}} H^{r_1,r_2}_{r_3} b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3}
-      -\frac{\sqrt{2}}{2\sqrt{15}} H^{r_1,r_2}_{r_3} b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3} b^\dagger_{r_n} b_{r_n}\\
-   &&   +\frac{\sqrt{2}}{\sqrt{15}} H^{r_1}_{r_2,r_3} b^\dagger_{r_1} b_{r_2} b_{r_3}
-      -\frac{\sqrt{2}}{2\sqrt{15}} H^{r_1}_{r_2,r_3} b^\dagger_{r_n} b_{r_n} b^\dagger_{r_1} b_{r_2} b_{r_3}  \\
-   &&   +\frac{\sqrt{2}}{24\sqrt{15}}\varepsilon_{r_1,r_2,r_3,r_4,r_n} H^{sym}_{r_n,r_m} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_4} b_{r_m}
-      +\frac{\sqrt{2}}{24\sqrt{15}}\varepsilon_{r_2,r_3,r_4,r_m,r_n} H_{sym}^{r_n,r_1} b^\dagger_{r_1} b_{r_2} b_{r_3} b_{r_4} b_{r_m}\\
-   &&   +\frac{1}{6\sqrt{15}} H^{r_1,r_2,r_3}_{r_4,r_m} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b_{r_4} b_{r_m}
-      +\frac{1}{6\sqrt{15}} H^{r_1,r_2}_{r_3,r_4,r_m} b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3} b_{r_4} b_{r_m}
-\quad\quad (normalized)
-  \f}
- */
-Braket GammaH(int n) {
-  if (getDim() != 10) {
-    cout << "Error: This function is only available for SO(10)...\nExiting." << endl;
-    exit(1);
+/*! \brief Builds the template of key from the template of its family, replacing the index head by id
+  \param[in] family key of the psi_*(mode, id) constructor and mode
+  \param[in] key key of the new template
+  \param[in] id new index head
+  \param[out] out expression of the new template
+  \return false if the family has no template yet
+*/
+static bool RelabelTemplate(const string& family, const string& key, const string& id, Braket& out) {
+  map<string, shared_ptr<const So10Template> >::iterator it = families.find(TemplateKey(family));
+  if (it == families.end()) return false;
+  const So10Template& t = *it->second;
+  // indices "<prefix>1", ..., "<prefix>5" of the template become "<id>1", ..., "<id>5"
+  unordered_map<string, string> rename;
+  for (size_t i = 0; i < t.names.size(); i++) {
+    const string& name = t.names[i];
+    if (name.size() == t.prefix.size() + 1 && name.compare(0, t.prefix.size(), t.prefix) == 0 && name.back() >= '1' && name.back() <= '5')
+      rename[name] = id + name.back();
+  }
+  shared_ptr<So10Template> r = make_shared<So10Template>();
+  r->prefix = id;
+  unordered_map<int, int> remap;
+  for (size_t i = 0; i < t.names.size(); i++) {
+    unordered_map<string, string>::iterator rn = rename.find(t.names[i]);
+    string name = rn == rename.end() ? t.names[i] : rn->second;
+    r->names.push_back(name);
+    r->pos.push_back(newIdx(name));
+    remap[t.pos[i]] = r->pos.back();
+  }
+  r->exp = RemapIndices(t.exp, remap);
+  for (int i = 0; i < r->exp.size(); i++) {
+    string c = r->exp.Get(i).GetConst();
+    string renamed;
+    size_t last = 0;
+    ForEachIdentifier(c, [&](size_t b, size_t n) {
+      unordered_map<string, string>::iterator rn = rename.find(c.substr(b, n));
+      if (rn == rename.end()) return;
+      renamed.append(c, last, b - last);
+      renamed += rn->second;
+      last = b + n;
+    });
+    if (last == 0) continue;
+    renamed.append(c, last, string::npos);
+    r->exp.Get(i).SetConst(renamed);
   }
+  templates[TemplateKey(key)] = r;
+  out = r->exp;
+  return true;
+}
+
+void clearSO10Templates() {
+  templates.clear();
+  families.clear();
+}
+
+/*! \brief Builds GammaH(n), without its field declarations */
+static Braket BuildGammaH(int n) {
   Braket gamma;
   switch (n) {
     case 0:
       gamma = free(0, H, identity);
-      Field(H, 0, 0, ASYM);
       break;
     case 1:
       gamma = free(-1, sqrt(2) * H01(r1), b(r1));
       gamma += free(1, sqrt(2) * H10(r1), bt(r1));
-      Field(H, 0, 1, ASYM);
-      Field(H, 1, 0, ASYM);
       break;
     case 2:
       gamma = free(-2, i_ * sqrt(2) * H02(r1, r2) / 2, -b(r1) * b(r2));
       gamma += free(2, i_ * sqrt(2) * H20(r1, r2) / 2, -bt(r1) * bt(r2));
       gamma += free(0, i_ * (sqrt(2) * H11(r1, r2) + 1 / 5 * d_(r1, r2) * sqrt(10) * H), -bt(r1) * b(r2));
       gamma += free(0, i_ * sqrt(10) * H / 2, identity);
-      Field(H, 0, 0, ASYM);
-      Field(H, 1, 1, ASYM);
-      Field(H, 2, 0, ASYM);
-      Field(H, 0, 2, ASYM);
       break;
     case 3:  // Nath and the minus sign in David normalization ATENCAO AO PSIp E PSIm
       gamma = free(-3, 1 / 6 * (e_(r1, r2, r3, r4, r5) * H20(r4, r5) / sqrt(3)), b(r1) * b(r2) * b(r3));
@@ -152,12 +270,6 @@ Braket GammaH(int n) {
       gamma += free(1, 2 * H10(r1) / sqrt(3), bt(r1));
       newId("r4");
       newId("r5");
-      Field(H, 1, 0, ASYM);
-      Field(H, 0, 1, ASYM);
-      Field(H, 2, 0, ASYM);
-      Field(H, 0, 2, ASYM);
-      Field(H, 2, 1, ASYM);
-      Field(H, 1, 2, ASYM);
       break;
     case 4:
       gamma = free(2, sqrt(2) / 6 * (H31(r1, r2, r3, r4) / sqrt(3) + 1 / 3 * (d_(r3, r4) * H20(r1, r2) - d_(r2, r4) * H20(r1, r3) + d_(r1, r4) * H20(r2, r3))), bt(r1) * bt(r2) * bt(r3) * b(r4));
@@ -170,15 +282,6 @@ Braket GammaH(int n) {
       gamma += free(0, (sqrt(2) / 2 * H11(r1, r2) + 2 * d_(r1, r2) * H / sqrt(15)), -bt(r1) * b(r2));
       gamma += free(0, (1 / 4 * (H22(r1, r2, r3, r4) * sqrt(2) / sqrt(3) + sqrt(2) / 3 * (d_(r1, r4) * H11(r2, r3) - d_(r1, r3) * H11(r2, r4) + d_(r2, r3) * H11(r1, r4) - d_(r2, r4) * H11(r1, r3)) + (d_(r1, r4) * d_(r2, r3) - d_(r1, r3) * d_(r2, r4)) * H / sqrt(15))), bt(r1) * bt(r2) * b(r3) * b(r4));
       newId("r5");
-      Field(H, 0, 0, ASYM);
-      Field(H, 1, 0, ASYM);
-      Field(H, 0, 1, ASYM);
-      Field(H, 1, 1, ASYM);
-      Field(H, 2, 0, ASYM);
-      Field(H, 0, 2, ASYM);
-      Field(H, 2, 2, ASYM);
-      Field(H, 3, 1, ASYM);
-      Field(H, 1, 3, ASYM);
       break;
     case 5: /* verified 27/03/2015 */
       gamma = free(-5, 1 / 60 * e_(r1, r2, r3, r4, r5) * H / sqrt(15), b(r1) * b(r2) * b(r3) * b(r4) * b(r5));
@@ -203,6 +306,51 @@ Braket GammaH(int n) {
       gamma += free(-1, 1 / 6 * H23(r1, r2, r3, r4, rm) / sqrt(15), bt(r1) * bt(r2) * b(r3) * b(r4) * b(rm));
       newId("rn");
       newId("rm");
+      break;
+    default:
+      cout << "Gamma function not implemented for " << n << ".\nExiting..." << endl;
+      exit(1);
+      break;
+  }
+  return gamma;
+}
+
+/*! \brief Declares the fields of GammaH(n) to FORM */
+static void DeclareGammaH(int n) {
+  switch (n) {
+    case 0:
+      Field(H, 0, 0, ASYM);
+      break;
+    case 1:
+      Field(H, 0, 1, ASYM);
+      Field(H, 1, 0, ASYM);
+      break;
+    case 2:
+      Field(H, 0, 0, ASYM);
+      Field(H, 1, 1, ASYM);
+      Field(H, 2, 0, ASYM);
+      Field(H, 0, 2, ASYM);
+      break;
+    case 3:
+      Field(H, 1, 0, ASYM);
+      Field(H, 0, 1, ASYM);
+      Field(H, 2, 0, ASYM);
+      Field(H, 0, 2, ASYM);
+      Field(H, 2, 1, ASYM);
+      Field(H, 1, 2, ASYM);
+      break;
+    case 4:
+      Field(H, 0, 0, ASYM);
+      Field(H, 1, 0, ASYM);
+      Field(H, 0, 1, ASYM);
+      Field(H, 1, 1, ASYM);
+      Field(H, 2, 0, ASYM);
+      Field(H, 0, 2, ASYM);
+      Field(H, 2, 2, ASYM);
+      Field(H, 3, 1, ASYM);
+      Field(H, 1, 3, ASYM);
+      break;
+    case 5:
       Field(H, 0, 0, ASYM);
       Field(H, 1, 0, ASYM);
       Field(H, 0, 1, ASYM);
@@ -215,12 +363,119 @@ Braket GammaH(int n) {
       Field(H, 2, 3, ASYM);
       Field(H, 3, 2, ASYM);
       break;
+  }
+}
+
+/*!\brief Gamma's
+
+  GammaH(n):
+  n=0:
+  \f{eqnarray*}{
+  \Gamma_\mu \phi_\mu &=& H
+  \f}
+
+  n=1:
+  \f{eqnarray*}{
+  \Gamma_\mu \phi_\mu &=& \sqrt{2}\left(b_{r_1} H_{r_1} +  b^\dagger_{r_2} H^{r_2}  \right) \quad\quad (normalized)
+  \f}
+
+  n=2:
+  \f{eqnarray*}{
+  \Gamma_\mu\Gamma_\nu \phi_{\mu\nu} &=& -i \frac{\sqrt{2}}{2} H_{r_1,r_2} b_{r_1} b_{r_2}
+                                      -i \frac{\sqrt{2}}{2} H^{r_1,r_2} b^\dagger_{r_1} b^\dagger_{r_2}
+                                      -i \left(\sqrt{2} H^{r_1}_{r_2} + \frac{\sqrt{10}}{5} \delta_{r1,r2} H\right) b^\dagger_{r_1} b_{r_2}
+                                      +\frac{\sqrt{10}}{2} H  \quad\quad (normalized)
+  \f}
+
+  n=3:
+  \f{eqnarray*}{
+  \Gamma_\mu\Gamma_\nu\Gamma_\gamma \phi_{\mu\nu\gamma} &=&   \frac{1}{6\sqrt{3}} \varepsilon_{r1,r2,r3,r4,r5} \left( H^{r_4,r_5} b_{r_1} b_{r_2} b_{r_3} +  H_{r_4,r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3}\right)\\
+&& + \frac{1}{2\sqrt{3}} \left(2 H^{r_1}_{r_2,r_3} +  \delta_{r_1,r_2} H_{r_3} - \delta_{r_1,r_3} H_{r_2}\right)
+b^\dagger_{r_1} b_{r_2} b_{r_3}\\
+&& + \frac{1}{2\sqrt{3}} \left(2 H^{r_1,r_2}_{r_3} +  \delta_{r_1,r_3} H^{r_2} - \delta_{r_2,r_3} H^{r_1}\right)
+b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3}\\
+&&+\frac{2}{\sqrt{3}} \left(H^{r_1} b^\dagger_{r_1} - H_{r_1} b_{r_1}\right)
+   \quad\quad (normalized)
+  \f}
+  n=4:
+  \f{eqnarray*}{
+  \Gamma_\mu\Gamma_\nu\Gamma_\gamma \Gamma_\rho \phi_{\mu\nu\gamma\rho} &=&   \frac{1}{3\sqrt{2}} \left(\frac{1}{\sqrt{3}} H^{r_1,r_2,r_3}_{r_4} + \frac{1}{3}\left(\delta_{r_3,r_4} H^{r_1,r_2} - \delta_{r_2,r_4} H^{r_1,r_3} + \delta_{r_1,r_4} H^{r_2,r_3}\right)\right) b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b_{r_4}\\
+   &&-\frac{1}{3\sqrt{2}}\left(\frac{1}{\sqrt{3}}H^{r_1}_{r_2,r_3,r_4} + \frac{1}{3} \left(\delta_{r_1,r_4} H_{r_2,r_3} - \delta_{r_1,r_3} H_{r_2,r_4} + \delta_{r_1,r_2} H_{r_3,r_4}\right)\right) b^\dagger_{r_1} b_{r_2} b_{r_3} b_{r_4}\\
+   && +\frac{1}{12\sqrt{6}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H_{r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_4} + \frac{1}{12\sqrt{6}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H^{r_5} b_{r_1} b_{r_2} b_{r_3} b_{r_4}\\
+  &&-\frac{\sqrt{2}}{4} H^{r_1,r_2} b^\dagger_{r_1} b^\dagger_{r_2} +\frac{\sqrt{2}}{4} H_{r_1,r_2} b_{r_1} b_{r_2}\\
+  &&+\frac{\sqrt{5}}{2\sqrt{3}} H -\left(\frac{\sqrt{2}}{2} H^{r_1}_{r_2} +\frac{2\sqrt{5}}{5\sqrt{3}} \delta_{r_1,r_2} H\right) b^\dagger_{r_1} b_{r_2} \\
+  &&+\frac{1}{4}\left(\sqrt{\frac{2}{3}} H^{r_1,r_2}_{r_3,r_4} + \frac{\sqrt{2}}{3} \left(\delta_{r_1,r_4} H^{r_2}_{r_3} - \delta_{r_1,r_3} H^{r_2}_{r_4} + \delta_{r_2,r3} H^{r_1}_{r_4} - \delta_{r_2,r_4} H^{r_1}_{r_3} \right)
+  + \frac{\sqrt{5}}{5\sqrt{3}} \left(\delta_{r_1,r_4}  \delta_{r_2,r_3} - \delta_{r_1,r_3}  \delta_{r_2,r_4}\right) H \right)
+  b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3} b_{r_4}
+   \quad\quad (normalized)
+  \f}
+
+  n=5:
+  \f{eqnarray*}{
+  \Gamma_\mu\Gamma_\nu\Gamma_\gamma \Gamma_\rho \Gamma_\eta \phi_{\mu\nu\gamma\rho\eta} &=&   +\frac{\sqrt{15}}{60} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H b_{r_1} b_{r_2} b_{r_3} b_{r_4} b_{r_5}
+      +\frac{\sqrt{15}}{60} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_4} b^\dagger_{r_5}\\
+   &&   +\frac{\sqrt{2}}{2\sqrt{5}} H^{r_1} b^\dagger_{r_1}
+      -\frac{2\sqrt{2}}{3\sqrt{5}} H^{r_1}  b^\dagger_{r_1} b^\dagger_{r_n} b_{r_n}
+      +\frac{\sqrt{2}}{6\sqrt{5}}  H^{r_1} b^\dagger_{r_1} b^\dagger_{r_n} b_{r_n} b^\dagger_{r_m} b_{r_m}\\
+   &&   +\frac{\sqrt{2}}{2\sqrt{5}} H_{r_1}  b_{r_1}
+      -\frac{2\sqrt{2}}{3\sqrt{5}} H_{r_1} b^\dagger_{r_n} b_{r_n} b_{r_1}
+      +\frac{\sqrt{2}}{6\sqrt{5}} H_{r_1} b^\dagger_{r_n} b_{r_n} b^\dagger_{r_m} b_{r_m} b_{r_1}\\
+   &&   +\frac{\sqrt{2}}{12\sqrt{15}}  \varepsilon_{r_1,r_2,r_3,r_4,r_5} H_{r_4,r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3}
+      -\frac{\sqrt{2}}{12\sqrt{15}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H_{r_4,r_5} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_n} b_{r_n}\\
+   &&   +\frac{\sqrt{2}}{12\sqrt{15}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H^{r_4,r_5} b_{r_1} b_{r_2} b_{r_3}
+      -\frac{\sqrt{2}}{12\sqrt{15}} \varepsilon_{r_1,r_2,r_3,r_4,r_5} H^{r_4,r_5} b^\dagger_{r_n} b_{r_n} b_{r_1} b_{r_2} b_{r_3} \\
+   &&   +\frac{\sqrt{2}}{\sqrt{15}} H^{r_1,r_2}_{r_3} b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3}
+      -\frac{\sqrt{2}}{2\sqrt{15}} H^{r_1,r_2}_{r_3} b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3} b^\dagger_{r_n} b_{r_n}\\
+   &&   +\frac{\sqrt{2}}{\sqrt{15}} H^{r_1}_{r_2,r_3} b^\dagger_{r_1} b_{r_2} b_{r_3}
+      -\frac{\sqrt{2}}{2\sqrt{15}} H^{r_1}_{r_2,r_3} b^\dagger_{r_n} b_{r_n} b^\dagger_{r_1} b_{r_2} b_{r_3}  \\
+   &&   +\frac{\sqrt{2}}{24\sqrt{15}}\varepsilon_{r_1,r_2,r_3,r_4,r_n} H^{sym}_{r_n,r_m} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b^\dagger_{r_4} b_{r_m}
+      +\frac{\sqrt{2}}{24\sqrt{15}}\varepsilon_{r_2,r_3,r_4,r_m,r_n} H_{sym}^{r_n,r_1} b^\dagger_{r_1} b_{r_2} b_{r_3} b_{r_4} b_{r_m}\\
+   &&   +\frac{1}{6\sqrt{15}} H^{r_1,r_2,r_3}_{r_4,r_m} b^\dagger_{r_1} b^\dagger_{r_2} b^\dagger_{r_3} b_{r_4} b_{r_m}
+      +\frac{1}{6\sqrt{15}} H^{r_1,r_2}_{r_3,r_4,r_m} b^\dagger_{r_1} b^\dagger_{r_2} b_{r_3} b_{r_4} b_{r_m}
+\quad\quad (normalized)
+  \f}
+ */
+Braket GammaH(int n) {
+  if (getDim() != 10) {
+    cout << "Error: This function is only available for SO(10)...\nExiting." << endl;
+    exit(1);
+  }
+  string key = "GammaH:" + ToString<int>(n);
+  Braket gamma;
+  if (!UseTemplate(key, gamma)) gamma = MakeTemplate(key, BuildGammaH(n), "");
+  DeclareGammaH(n);
+  return gamma;
+}
+
+/*! \brief Declares the fields of psi_16p to FORM */
+static void DeclarePsi16p() {
+  Field(M, 0, 0, ASYM_WITH_FLAVOR);
+  Field(M, 2, 0, ASYM_WITH_FLAVOR);
+  Field(Mb, 0, 1, ASYM_WITH_FLAVOR);
+}
+
+/*! \brief Builds psi_16p(mode), without its field declarations */
+static Braket BuildPsi16p(OPMode mode) {
+  Braket exp;
+  switch (mode) {
+    case bra:
+      exp = bra(0, M(A), identity);
+      exp += bra(2, 1 / 2 * M20(A, o, p), b(p) * b(o));
+      exp += bra(4, 1 / 24 * e_(o, p, q, r, s) * Mb01(A, o), b(s) * b(r) * b(q) * b(p));
+      newId("A");
+      break;
+    case ket:
+      exp = ket(0, M(B), identity);
+      exp += ket(2, 1 / 2 * M20(B, j, k), bt(j) * bt(k));
+      exp += ket(4, 1 / 24 * e_(j, k, l, m, n) * Mb01(B, j), bt(k) * bt(l) * bt(m) * bt(n));
+      newId("B");
+      break;
     default:
-      cout << "Gamma function not implemented for " << n << ".\nExiting..." << endl;
+      cout << "Expression mode not supported: " << mode << endl;
       exit(1);
       break;
   }
-  return gamma;
+  return exp;
 }
 
 /*!\brief Constructs the ket and bra in the 16th SO(10) representation
@@ -251,18 +506,29 @@ Braket psi_16p(OPMode mode) {
     cout << "This is only for SO(10)...\nExiting..." << endl;
     exit(10);
   }
+  string key = "psi_16p:" + ToString<int>(mode);
+  Braket exp;
+  if (!UseTemplate(key, exp)) exp = MakeTemplate(key, BuildPsi16p(mode));
+  DeclarePsi16p();
+  return exp;
+}
+
+/*! \brief Builds psi_16p(mode, id), without its field declarations */
+static Braket BuildPsi16p(OPMode mode, string id) {
   Braket exp;
   switch (mode) {
     case bra:
       exp = bra(0, M(A), identity);
-      exp += bra(2, 1 / 2 * M20(A, o, p), b(p) * b(o));
-      exp += bra(4, 1 / 24 * e_(o, p, q, r, s) * Mb01(A, o), b(s) * b(r) * b(q) * b(p));
+      exp += Braket(2, "1/2 * M20(A," + makeId(id, 1) + "," + makeId(id, 2) + ")", bb(makeId(id, 2)) * bb(makeId(id, 1)), bra);
+      exp += Braket(4, "1/24 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Mb01(A," + makeId(id, 1) + ")",
+                    bb(makeId(id, 5)) * bb(makeId(id, 4)) * bb(makeId(id, 3)) * bb(makeId(id, 2)), bra);
       newId("A");
       break;
     case ket:
       exp = ket(0, M(B), identity);
-      exp += ket(2, 1 / 2 * M20(B, j, k), bt(j) * bt(k));
-      exp += ket(4, 1 / 24 * e_(j, k, l, m, n) * Mb01(B, j), bt(k) * bt(l) * bt(m) * bt(n));
+      exp += Braket(2, "1/2 * M20(B," + makeId(id, 1) + "," + makeId(id, 2) + ")", bbt(makeId(id, 1)) * bbt(makeId(id, 2)), ket);
+      exp += Braket(4, "1/24 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Mb01(B," + makeId(id, 1) + ")",
+                    bbt(makeId(id, 2)) * bbt(makeId(id, 3)) * bbt(makeId(id, 4)) * bbt(makeId(id, 5)), ket);
       newId("B");
       break;
     default:
@@ -270,9 +536,6 @@ Braket psi_16p(OPMode mode) {
       exit(1);
       break;
   }
-  Field(M, 0, 0, ASYM_WITH_FLAVOR);
-  Field(M, 2, 0, ASYM_WITH_FLAVOR);
-  Field(Mb, 0, 1, ASYM_WITH_FLAVOR);
   return exp;
 }
 
@@ -304,20 +567,35 @@ Braket psi_16p(OPMode mode, string id) {
     cout << "This is only for SO(10)...\nExiting..." << endl;
     exit(10);
   }
+  string family = "psi_16p:" + ToString<int>(mode);
+  string key = family + ":" + id;
+  Braket exp;
+  if (!UseTemplate(key, exp) && !RelabelTemplate(family, key, id, exp)) exp = MakeTemplate(key, BuildPsi16p(mode, id), id, family);
+  DeclarePsi16p();
+  return exp;
+}
+
+/*! \brief Declares the fields of psi_16m to FORM */
+static void DeclarePsi16m() {
+  Field(N, 1, 0, ASYM_WITH_FLAVOR);
+  Field(Nb, 0, 2, ASYM_WITH_FLAVOR);
+  Field(N, 0, 0, ASYM_WITH_FLAVOR);
+}
+
+/*! \brief Builds psi_16m(mode), without its field declarations */
+static Braket BuildPsi16m(OPMode mode) {
   Braket exp;
   switch (mode) {
     case bra:
-      exp = bra(0, M(A), identity);
-      exp += Braket(2, "1/2 * M20(A," + makeId(id, 1) + "," + makeId(id, 2) + ")", bb(makeId(id, 2)) * bb(makeId(id, 1)), bra);
-      exp += Braket(4, "1/24 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Mb01(A," + makeId(id, 1) + ")",
-                    bb(makeId(id, 5)) * bb(makeId(id, 4)) * bb(makeId(id, 3)) * bb(makeId(id, 2)), bra);
+      exp = bra(1, N10(A, o), b(o));
+      exp += bra(3, 1 / 12 * e_(o, p, q, r, s) * Nb02(A, o, p), b(s) * b(r) * b(q));
+      exp += bra(5, 1 / 120 * e_(o, p, q, r, s) * N(A), b(s) * b(r) * b(q) * b(p) * b(o));
       newId("A");
       break;
     case ket:
-      exp = ket(0, M(B), identity);
-      exp += Braket(2, "1/2 * M20(B," + makeId(id, 1) + "," + makeId(id, 2) + ")", bbt(makeId(id, 1)) * bbt(makeId(id, 2)), ket);
-      exp += Braket(4, "1/24 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Mb01(B," + makeId(id, 1) + ")",
-                    bbt(makeId(id, 2)) * bbt(makeId(id, 3)) * bbt(makeId(id, 4)) * bbt(makeId(id, 5)), ket);
+      exp = ket(1, N10(B, j), bt(j));
+      exp += ket(3, 1 / 12 * e_(j, k, l, m, n) * Nb02(B, j, k), bt(l) * bt(m) * bt(n));
+      exp += ket(5, 1 / 120 * e_(j, k, l, m, n) * N(B), bt(j) * bt(k) * bt(l) * bt(m) * bt(n));
       newId("B");
       break;
     default:
@@ -325,9 +603,6 @@ Braket psi_16p(OPMode mode, string id) {
       exit(1);
       break;
   }
-  Field(M, 0, 0, ASYM_WITH_FLAVOR);
-  Field(M, 2, 0, ASYM_WITH_FLAVOR);
-  Field(Mb, 0, 1, ASYM_WITH_FLAVOR);
   return exp;
 }
 
@@ -356,18 +631,29 @@ Braket psi_16m(OPMode mode) { /* CS corrected some indices! 27/03/2015 */
     cout << "This is only for SO(10)...\nExiting..." << endl;
     exit(10);
   }
+  string key = "psi_16m:" + ToString<int>(mode);
+  Braket exp;
+  if (!UseTemplate(key, exp)) exp = MakeTemplate(key, BuildPsi16m(mode));
+  DeclarePsi16m();
+  return exp;
+}
+
+/*! \brief Builds psi_16m(mode, id), without its field declarations */
+static Braket BuildPsi16m(OPMode mode, string id) {
   Braket exp;
   switch (mode) {
     case bra:
       exp = bra(1, N10(A, o), b(o));
-      exp += bra(3, 1 / 12 * e_(o, p, q, r, s) * Nb02(A, o, p), b(s) * b(r) * b(q));
-      exp += bra(5, 1 / 120 * e_(o, p, q, r, s) * N(A), b(s) * b(r) * b(q) * b(p) * b(o));
+      exp += Braket(3, "1/12 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Nb02(A," + makeId(id, 1) + "," + makeId(id, 2) + ")", bb(makeId(id, 5)) * bb(makeId(id, 4)) * bb(makeId(id, 3)), bra);
+      exp += Braket(5, "1/120 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * N(A)", bb(makeId(id, 5)) * bb(makeId(id, 4)) * bb(makeId(id, 3)) * bb(makeId(id, 2)) * bb(makeId(id, 1)), bra);
       newId("A");
       break;
     case ket:
       exp = ket(1, N10(B, j), bt(j));
-      exp += ket(3, 1 / 12 * e_(j, k, l, m, n) * Nb02(B, j, k), bt(l) * bt(m) * bt(n));
-      exp += ket(5, 1 / 120 * e_(j, k, l, m, n) * N(B), bt(j) * bt(k) * bt(l) * bt(m) * bt(n));
+      exp += Braket(3, "1/12 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Nb02(B," + makeId(id, 1) + "," + makeId(id, 2) + ")",
+                    bbt(makeId(id, 3)) * bbt(makeId(id, 4)) * bbt(makeId(id, 5)), ket);
+      exp += Braket(5, "1/120 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * N(B)",
+                    bbt(makeId(id, 1)) * bbt(makeId(id, 2)) * bbt(makeId(id, 3)) * bbt(makeId(id, 4)) * bbt(makeId(id, 5)), ket);
       newId("B");
       break;
     default:
@@ -375,9 +661,6 @@ Braket psi_16m(OPMode mode) { /* CS corrected some indices! 27/03/2015 */
       exit(1);
       break;
   }
-  Field(N, 1, 0, ASYM_WITH_FLAVOR);
-  Field(Nb, 0, 2, ASYM_WITH_FLAVOR);
-  Field(N, 0, 0, ASYM_WITH_FLAVOR);
   return exp;
 }
 
@@ -409,20 +692,46 @@ Braket psi_16m(OPMode mode, string id) {
     cout << "This is only for SO(10)...\nExiting..." << endl;
     exit(10);
   }
+  string family = "psi_16m:" + ToString<int>(mode);
+  string key = family + ":" + id;
+  Braket exp;
+  if (!UseTemplate(key, exp) && !RelabelTemplate(family, key, id, exp)) exp = MakeTemplate(key, BuildPsi16m(mode, id), id, family);
+  DeclarePsi16m();
+  return exp;
+}
+
+// 144+
+/*! \brief Declares the fields of psi_144p to FORM */
+static void DeclarePsi144p() {
+  Field(P, 1, 0, ASYM_WITH_FLAVOR);
+  Field(P, 1, 3, ASYM_WITH_FLAVOR);
+  Field(P, 0, 2, ASYM_WITH_FLAVOR);
+  Field(P, 1, 1, ASYM_WITH_FLAVOR);
+  Field(P, 0, 1, ASYM_WITH_FLAVOR);
+  Field(P, 0, 2, SYM_WITH_FLAVOR);
+  Field(P, 2, 1, ASYM_WITH_FLAVOR);
+}
+
+/*! \brief Builds psi_144p(mode), without its field declarations */
+static Braket BuildPsi144p(OPMode mode) {
   Braket exp;
   switch (mode) {
     case bra:
-      exp = bra(1, N10(A, o), b(o));
-      exp += Braket(3, "1/12 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Nb02(A," + makeId(id, 1) + "," + makeId(id, 2) + ")", bb(makeId(id, 5)) * bb(makeId(id, 4)) * bb(makeId(id, 3)), bra);
-      exp += Braket(5, "1/120 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * N(A)", bb(makeId(id, 5)) * bb(makeId(id, 4)) * bb(makeId(id, 3)) * bb(makeId(id, 2)) * bb(makeId(id, 1)), bra);
+      exp = bra(1, P10(A, n) * 2 / sqrt(5), identity);
+      exp += bra(3, (1 / 12 * e_(o, p, q, r, s) * P13(A, n, q, r, s) - 1 / 12 * e_(o, p, n, r, s) * P02(A, r, s) * sqrt(6 / 5)), b(p) * b(o));
+      exp += bra(5, 1 / 24 * e_(o, p, q, r, s) * P11(A, n, o), b(s) * b(r) * b(q) * b(p));
+      exp += bra(-1, P01(A, n), identity);
+      exp += bra(1, (P21(A, o, p, n) / 2 + (d_(o, n) * P10(A, p) - d_(p, n) * P10(A, o)) / (4 * sqrt(5))), b(p) * b(o));
+      exp += bra(3, (1 / 48 * e_(o, p, q, r, s) * (P02(A, o, n) * sqrt(6 / 5) + Ps02(A, o, n) * sqrt(2))), b(s) * b(r) * b(q) * b(p));
       newId("A");
       break;
     case ket:
-      exp = ket(1, N10(B, j), bt(j));
-      exp += Braket(3, "1/12 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * Nb02(B," + makeId(id, 1) + "," + makeId(id, 2) + ")",
-                    bbt(makeId(id, 3)) * bbt(makeId(id, 4)) * bbt(makeId(id, 5)), ket);
-      exp += Braket(5, "1/120 * e_(" + makeId(id, 1) + "," + makeId(id, 2) + "," + makeId(id, 3) + "," + makeId(id, 4) + "," + makeId(id, 5) + ") * N(B)",
-                    bbt(makeId(id, 1)) * bbt(makeId(id, 2)) * bbt(makeId(id, 3)) * bbt(makeId(id, 4)) * bbt(makeId(id, 5)), ket);
+      exp = ket(1, P10(B, n) * 2 / sqrt(5), identity);
+      exp += ket(3, (1 / 12 * e_(i, j, k, l, m) * P13(B, n, k, l, m) - 1 / 12 * e_(i, j, n, l, m) * P02(B, l, m) * sqrt(6 / 5)), bt(i) * bt(j));
+      exp += ket(5, 1 / 24 * e_(i, j, k, l, m) * P11(B, n, i), bt(j) * bt(k) * bt(l) * bt(m));
+      exp += ket(-1, P01(B, n), identity);
+      exp += ket(1, (P21(B, i, j, n) / 2 + (d_(i, n) * P10(B, j) - d_(j, n) * P10(B, i)) / (4 * sqrt(5))), bt(i) * bt(j));
+      exp += ket(3, 1 / 48 * e_(i, j, k, l, m) * (P02(B, i, n) * sqrt(6 / 5) + Ps02(B, i, n) * sqrt(2)), bt(j) * bt(k) * bt(l) * bt(m));
       newId("B");
       break;
     default:
@@ -430,13 +739,10 @@ Braket psi_16m(OPMode mode, string id) {
       exit(1);
       break;
   }
-  Field(N, 1, 0, ASYM_WITH_FLAVOR);
-  Field(Nb, 0, 2, ASYM_WITH_FLAVOR);
-  Field(N, 0, 0, ASYM_WITH_FLAVOR);
+  newId("n");
   return exp;
 }
 
-// 144+
 /*!\brief Constructs the ket and bra in the 144th-bar SO(10) representation
 
  Note that A and B are flavour indices
@@ -468,24 +774,46 @@ Braket psi_144p(OPMode mode) {
     cout << "This is only for SO(10)...\nExiting..." << endl;
     exit(10);
   }
+  string key = "psi_144p:" + ToString<int>(mode);
+  Braket exp;
+  if (!UseTemplate(key, exp)) exp = MakeTemplate(key, BuildPsi144p(mode));
+  DeclarePsi144p();
+  return exp;
+}
+
+// 144-
+/*! \brief Declares the fields of psi_144m to FORM */
+static void DeclarePsi144m() {
+  Field(Q, 1, 0, ASYM_WITH_FLAVOR);
+  Field(Q, 0, 1, ASYM_WITH_FLAVOR);
+  Field(Q, 1, 1, ASYM_WITH_FLAVOR);
+  Field(Q, 2, 0, ASYM_WITH_FLAVOR);
+  Field(Q, 2, 0, SYM_WITH_FLAVOR);
+  Field(Q, 1, 2, ASYM_WITH_FLAVOR);
+  Field(Q, 3, 1, ASYM_WITH_FLAVOR);
+}
+
+/*! \brief Builds psi_144m(mode), without its field declarations */
+static Braket BuildPsi144m(OPMode mode) {
   Braket exp;
   switch (mode) {
     case bra:
-      exp = bra(1, P10(A, n) * 2 / sqrt(5), identity);
-      exp += bra(3, (1 / 12 * e_(o, p, q, r, s) * P13(A, n, q, r, s) - 1 / 12 * e_(o, p, n, r, s) * P02(A, r, s) * sqrt(6 / 5)), b(p) * b(o));
-      exp += bra(5, 1 / 24 * e_(o, p, q, r, s) * P11(A, n, o), b(s) * b(r) * b(q) * b(p));
-      exp += bra(-1, P01(A, n), identity);
-      exp += bra(1, (P21(A, o, p, n) / 2 + (d_(o, n) * P10(A, p) - d_(p, n) * P10(A, o)) / (4 * sqrt(5))), b(p) * b(o));
-      exp += bra(3, (1 / 48 * e_(o, p, q, r, s) * (P02(A, o, n) * sqrt(6 / 5) + Ps02(A, o, n) * sqrt(2))), b(s) * b(r) * b(q) * b(p));
+
+      exp = bra(1, 1 / 120 * e_(o, p, q, r, s) * Q10(A, n), b(o) * b(p) * b(q) * b(r) * b(s));
+      exp += bra(4, 1 / 12 * e_(o, p, q, r, s) * (Q12(A, n, o, p) + 1 / (2 * sqrt(5)) * (d_(n, o) * Q01(A, p) - d_(n, p) * Q01(A, o))), b(s) * b(r) * b(q));
+      exp += bra(2, (1 / 2 * Q20(A, o, n) * sqrt(6 / 5) + 1 / 2 * Qs20(A, o, n) * sqrt(2)), b(o));
+      exp += bra(0, Q11(A, o, n), b(o));
+      exp += bra(2, 1 / 72 * e_(o, p, qq, rr, ss) * (e_(o, p, q, r, s) * Q31(A, q, r, s, n) - e_(o, p, n, r, s) * Q20(A, r, s) * sqrt(6 / 5)), b(ss) * b(rr) * b(qq));
+      exp += bra(-1, 1 / 120 * e_(o, p, q, r, s) * Q01(A, n) * 2 / sqrt(5), b(o) * b(p) * b(q) * b(r) * b(s));
       newId("A");
       break;
     case ket:
-      exp = ket(1, P10(B, n) * 2 / sqrt(5), identity);
-      exp += ket(3, (1 / 12 * e_(i, j, k, l, m) * P13(B, n, k, l, m) - 1 / 12 * e_(i, j, n, l, m) * P02(B, l, m) * sqrt(6 / 5)), bt(i) * bt(j));
-      exp += ket(5, 1 / 24 * e_(i, j, k, l, m) * P11(B, n, i), bt(j) * bt(k) * bt(l) * bt(m));
-      exp += ket(-1, P01(B, n), identity);
-      exp += ket(1, (P21(B, i, j, n) / 2 + (d_(i, n) * P10(B, j) - d_(j, n) * P10(B, i)) / (4 * sqrt(5))), bt(i) * bt(j));
-      exp += ket(3, 1 / 48 * e_(i, j, k, l, m) * (P02(B, i, n) * sqrt(6 / 5) + Ps02(B, i, n) * sqrt(2)), bt(j) * bt(k) * bt(l) * bt(m));
+      exp = ket(1, Q10(B, n) / 120 * e_(i, j, k, l, m), bt(i) * bt(j) * bt(k) * bt(l) * bt(m));
+      exp += ket(4, 1 / 12 * e_(i, j, k, l, m) * (Q12(B, n, i, j) + 1 / (2 * sqrt(5)) * (d_(n, i) * Q01(B, j) - d_(n, j) * Q01(B, i))), bt(k) * bt(l) * bt(m));
+      exp += ket(2, (1 / 2 * (Q20(B, i, n) * sqrt(6 / 5) + Qs20(B, i, n) * sqrt(2))), bt(i));
+      exp += ket(-1, 1 / 120 * e_(i, j, k, l, m) * Q01(B, n) * 2 / sqrt(5), bt(i) * bt(j) * bt(k) * bt(l) * bt(m));
+      exp += ket(2, 1 / 72 * e_(i, j, kk, ll, mm) * (e_(i, j, k, l, m) * Q31(B, k, l, m, n) - e_(i, j, n, l, m) * Q20(B, l, m) * sqrt(6 / 5)), bt(kk) * bt(ll) * bt(mm));
+      exp += ket(0, Q11(B, i, n), bt(i));
       newId("B");
       break;
     default:
@@ -494,17 +822,9 @@ Braket psi_144p(OPMode mode) {
       break;
   }
   newId("n");
-  Field(P, 1, 0, ASYM_WITH_FLAVOR);
-  Field(P, 1, 3, ASYM_WITH_FLAVOR);
-  Field(P, 0, 2, ASYM_WITH_FLAVOR);
-  Field(P, 1, 1, ASYM_WITH_FLAVOR);
-  Field(P, 0, 1, ASYM_WITH_FLAVOR);
-  Field(P, 0, 2, SYM_WITH_FLAVOR);
-  Field(P, 2, 1, ASYM_WITH_FLAVOR);
   return exp;
 }
 
-// 144-
 /*!\brief Constructs the ket and bra in the 144th SO(10) representation
 
  Note that A and B are flavour indices
@@ -540,40 +860,10 @@ Braket psi_144m(OPMode mode) {
     cout << "This is only for SO(10)...\nExiting..." << endl;
     exit(10);
   }
+  string key = "psi_144m:" + ToString<int>(mode);
   Braket exp;
-  switch (mode) {
-    case bra:
-
-      exp = bra(1, 1 / 120 * e_(o, p, q, r, s) * Q10(A, n), b(o) * b(p) * b(q) * b(r) * b(s));
-      exp += bra(4, 1 / 12 * e_(o, p, q, r, s) * (Q12(A, n, o, p) + 1 / (2 * sqrt(5)) * (d_(n, o) * Q01(A, p) - d_(n, p) * Q01(A, o))), b(s) * b(r) * b(q));
-      exp += bra(2, (1 / 2 * Q20(A, o, n) * sqrt(6 / 5) + 1 / 2 * Qs20(A, o, n) * sqrt(2)), b(o));
-      exp += bra(0, Q11(A, o, n), b(o));
-      exp += bra(2, 1 / 72 * e_(o, p, qq, rr, ss) * (e_(o, p, q, r, s) * Q31(A, q, r, s, n) - e_(o, p, n, r, s) * Q20(A, r, s) * sqrt(6 / 5)), b(ss) * b(rr) * b(qq));
-      exp += bra(-1, 1 / 120 * e_(o, p, q, r, s) * Q01(A, n) * 2 / sqrt(5), b(o) * b(p) * b(q) * b(r) * b(s));
-      newId("A");
-      break;
-    case ket:
-      exp = ket(1, Q10(B, n) / 120 * e_(i, j, k, l, m), bt(i) * bt(j) * bt(k) * bt(l) * bt(m));
-      exp += ket(4, 1 / 12 * e_(i, j, k, l, m) * (Q12(B, n, i, j) + 1 / (2 * sqrt(5)) * (d_(n, i) * Q01(B, j) - d_(n, j) * Q01(B, i))), bt(k) * bt(l) * bt(m));
-      exp += ket(2, (1 / 2 * (Q20(B, i, n) * sqrt(6 / 5) + Qs20(B, i, n) * sqrt(2))), bt(i));
-      exp += ket(-1, 1 / 120 * e_(i, j, k, l, m) * Q01(B, n) * 2 / sqrt(5), bt(i) * bt(j) * bt(k) * bt(l) * bt(m));
-      exp += ket(2, 1 / 72 * e_(i, j, kk, ll, mm) * (e_(i, j, k, l, m) * Q31(B, k, l, m, n) - e_(i, j, n, l, m) * Q20(B, l, m) * sqrt(6 / 5)), bt(kk) * bt(ll) * bt(mm));
-      exp += ket(0, Q11(B, i, n), bt(i));
-      newId("B");
-      break;
-    default:
-      cout << "Expression mode not supported: " << mode << endl;
-      exit(1);
-      break;
-  }
-  newId("n");
-  Field(Q, 1, 0, ASYM_WITH_FLAVOR);
-  Field(Q, 0, 1, ASYM_WITH_FLAVOR);
-  Field(Q, 1, 1, ASYM_WITH_FLAVOR);
-  Field(Q, 2, 0, ASYM_WITH_FLAVOR);
-  Field(Q, 2, 0, SYM_WITH_FLAVOR);
-  Field(Q, 1, 2, ASYM_WITH_FLAVOR);
-  Field(Q, 3, 1, ASYM_WITH_FLAVOR);
+  if (!UseTemplate(key, exp)) exp = MakeTemplate(key, BuildPsi144m(mode));
+  DeclarePsi144m();
   return exp;
 }
 
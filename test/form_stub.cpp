@@ -0,0 +1,147 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+// Stand-in for the FORM binary speaking the protocol of FormSession, used by the tests.
+// Every "#toexternal" answers with "<calls>*y+<n>*x", where calls counts the programs
+// received by this process and n is the number of "Local R?" expressions of the program.
+// Run as "form_stub file_in.frm" it prints "R = " followed by the sum of the "Local R?" expressions of the file,
+// and appends the file to $FORM_STUB_LOG if it is set.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+using namespace std;
+
+static int fdin = -1, fdout = -1;
+static string pending;
+
+static bool readLine(string& line) {
+	while (true) {
+		size_t end = pending.find('\n');
+		if (end != string::npos) {
+			line = pending.substr(0, end);
+			pending.erase(0, end + 1);
+			return true;
+		}
+		char buf[4096];
+		ssize_t n = read(fdin, buf, sizeof(buf));
+		if (n <= 0) return false;
+		pending.append(buf, n);
+	}
+}
+
+static void writeAll(const string& s) {
+	size_t done = 0;
+	while (done < s.size()) {
+		ssize_t n = write(fdout, s.data() + done, s.size() - done);
+		if (n <= 0) exit(1);
+		done += n;
+	}
+}
+
+static int sumFile(const char* name) {
+	ifstream in(name);
+	if (!in.is_open()) return 1;
+	string line, sum, program;
+	while (getline(in, line)) {
+		program += line + "\n";
+		if (line.find("Local R") != 0 || line.find("Local R =") == 0) continue;
+		// one expression, up to the line ending with ';'
+		string local = line;
+		while (local.empty() || local[local.size() - 1] != ';') {
+			if (!getline(in, line)) break;
+			program += line + "\n";
+			local += line;
+		}
+		size_t b = local.find("= "), e = local.rfind(';');
+		string term = local.substr(b + 2, e - b - 2);
+		if (!sum.empty() && term[0] != '+' && term[0] != '-') sum += "+";
+		sum += term;
+	}
+	// FORM_STUB_LOG collects the programs, see test/golden.cmake
+	const char* log = getenv("FORM_STUB_LOG");
+	if (log) {
+		ofstream out(log, ios::app);
+		out << program;
+	}
+	cout << "   R =\n      " << sum << ";\n" << endl;
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	if (argc == 2) return sumFile(argv[1]);
+	for (int i = 1; i + 1 < argc; i++)
+		if (strcmp(argv[i], "-pipe") == 0 && sscanf(argv[i + 1], "%d,%d", &fdin, &fdout) != 2) return 1;
+	if (fdin < 0 || fdout < 0) return 1;
+	ostringstream pid;
+	pid << getpid() << "\n";
+	writeAll(pid.str());
+	string line;
+	if (!readLine(line) || !readLine(line) || !line.empty()) return 1;
+	int calls = 0;
+	while (true) {
+		// one program, up to the prompt
+		int locals = 0;
+		bool stop = false;
+		string answer;
+		while (true) {
+			if (!readLine(line)) return 0;
+			if (line.empty()) break;
+			if (line.find("#redefine SOSPINSTOP") == 0) stop = true;
+			if (line.find("Local R") == 0 && line.find("Local R =") != 0) locals++;
+			if (line.find("#toexternal") == 0) answer += line + "\n";
+		}
+		if (stop) return 0;
+		calls++;
+		istringstream in(answer);
+		while (getline(in, line)) {
+			size_t b = line.find('"'), e = line.rfind('"');
+			string format = line.substr(b + 1, e - b - 1);
+			ostringstream out;
+			for (size_t i = 0; i < format.size(); i++) {
+				if (format.compare(i, 2, "\\n") == 0) {
+					out << "\n";
+					i++;
+				} else if (format.compare(i, 2, "%E") == 0) {
+					out << calls << "*y+" << locals << "*x";
+					i++;
+				} else
+					out << format[i];
+			}
+			writeAll(out.str());
+		}
+	}
+}
@@ -0,0 +1,33 @@
+# Runs an example program with form_stub as FORM and compares the FORM programs it writes,
+# ie, the Braket expressions before FORM, with the golden file.
+#
+#   cmake -DEXAMPLE=<program> -DSTUB=<form_stub> -DGOLDEN=<file.frm> -DWORKDIR=<dir> -P golden.cmake
+#
+# With the environment variable SOSPIN_UPDATE_GOLDEN set the golden file is rewritten instead.
+
+file(REMOVE_RECURSE ${WORKDIR})
+file(MAKE_DIRECTORY ${WORKDIR})
+# FindForm uses ./form before PATH_TO_FORM
+configure_file(${STUB} ${WORKDIR}/form COPYONLY)
+
+set(ENV{FORM_STUB_LOG} ${WORKDIR}/programs.frm)
+execute_process(COMMAND ${EXAMPLE} WORKING_DIRECTORY ${WORKDIR} RESULT_VARIABLE status OUTPUT_QUIET)
+if(NOT status EQUAL 0)
+  message(FATAL_ERROR "${EXAMPLE} failed: ${status}")
+endif()
+
+file(READ ${WORKDIR}/programs.frm actual)
+# the FORM program header has the date and time of the run
+string(REGEX REPLACE "[0-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9]\\.[0-9][0-9]:[0-9][0-9]:[0-9][0-9]"
+       "YYYY-MM-DD.hh:mm:ss" actual "${actual}")
+
+if(DEFINED ENV{SOSPIN_UPDATE_GOLDEN})
+  file(WRITE ${GOLDEN} "${actual}")
+  return()
+endif()
+
+file(READ ${GOLDEN} expected)
+if(NOT actual STREQUAL expected)
+  file(WRITE ${WORKDIR}/actual.frm "${actual}")
+  message(FATAL_ERROR "FORM programs differ from ${GOLDEN}, see ${WORKDIR}/actual.frm")
+endif()
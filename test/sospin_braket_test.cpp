@@ -0,0 +1,679 @@
+// SOSpin Library
+// Copyright (C) 2015,2023 SOSpin Project
+//
+//   Authors:
+//     David da Costa (david.dacosta@dlr.de)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+//       sospin_braket_test.cpp created on 17/10/2026
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <sstream>
+
+#include <sospin/son.h>
+#include <sospin/tools/so10.h>
+
+using namespace sospin;
+using namespace std;
+
+/*! \brief Sum of the signs of each (constant part, product of deltas) of an evaluated Braket, zero sums removed */
+static map<string, int> canonical(Braket& exp) {
+	map<string, int> terms;
+	for (int i = 0; i < exp.size(); i++) {
+		BraketOneTerm& term = exp.Get(i);
+		list<DList>& dl = term.GetTerm();
+		for (list<DList>::iterator it = dl.begin(); it != dl.end(); ++it) {
+			vector<string> deltas;
+			for (unsigned int k = 0; k < (*it).size(); k++) {
+				elemType e = (*it).at(k);
+				EXPECT_NE(0u, e.getType());
+				EXPECT_NE(1u, e.getType());
+				if (e.getType() == 2) deltas.push_back("d(" + getIdx(e.getIdx1()) + "," + getIdx(e.getIdx2()) + ")");
+			}
+			sort(deltas.begin(), deltas.end());
+			string key = term.GetConst() + "#";
+			for (size_t k = 0; k < deltas.size(); k++) key += deltas[k];
+			terms[key] += (*it).getSign();
+		}
+	}
+	for (map<string, int>::iterator it = terms.begin(); it != terms.end();) {
+		if (it->second == 0)
+			terms.erase(it++);
+		else
+			++it;
+	}
+	return terms;
+}
+
+/*! \brief Evaluates "exp" to deltas with both methods and compares the results */
+static void crossCheck(const Braket& exp) {
+	Braket iterative = exp;
+	Braket wick = exp;
+	iterative.evaluate(true, ITERATIVE);
+	wick.evaluate(true, WICK);
+	map<string, int> a = canonical(iterative);
+	map<string, int> b = canonical(wick);
+	EXPECT_FALSE(a.empty());
+	EXPECT_TRUE(a == b);
+}
+
+TEST(SospinBraketTest, WickMatchesIterativeGeneric) {
+	setDim(10);
+	setVerbosity(SILENT);
+	DList ops = DList(0, newIdx("a")) * DList(0, newIdx("b")) * DList(0, newIdx("c"));
+	DList dags = DList(1, newIdx("d")) * DList(1, newIdx("e")) * DList(1, newIdx("f"));
+	DList mixed = DList(0, newIdx("a")) * DList(1, newIdx("d")) * DList(0, newIdx("b")) * DList(1, newIdx("e"));
+	Braket exp = Braket(0, "x", ops * dags, braket);
+	exp += Braket(0, "y", mixed, braket);
+	crossCheck(exp);
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, WickMatchesIterativeSO10) {
+	setDim(10);
+	setVerbosity(SILENT);
+	crossCheck(psi_16p(bra, "i") * Bop("j") * GammaH(1) * psi_16p(ket, "k"));
+	crossCheck(psi_16p(bra, "i") * Bop("j") * GammaH(3) * psi_16p(ket, "k"));
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, WickMatchesIterativeNumeric) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket exp = Braket(0, "", bb(1) * bb(2), bra) * BopIdnum() * Braket(0, "", bbt(3) * bbt(4) * bbt(5), ket);
+	exp += Braket(0, "x", identity, bra) * BopIdnum() * Braket(0, "", bbt(1) * bbt(2) * bbt(3) * bbt(4) * bbt(5), ket);
+	// numeric brakets are otherwise evaluated on the Fock space
+	unsetFockEvaluation();
+	crossCheck(exp);
+	setFockEvaluation();
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, ThreadedEvaluateIsDeterministic) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket exp = psi_16p(bra, "i") * Bop("j") * GammaH(3) * psi_16p(ket, "k");
+	for (int onlydeltas = 0; onlydeltas < 2; onlydeltas++) {
+		Braket serial = exp;
+		Braket threaded = exp;
+		setThreads(1);
+		serial.evaluate(onlydeltas);
+		setThreads(4);
+		threaded.evaluate(onlydeltas);
+		setThreads(1);
+		ostringstream os0, os1;
+		os0 << serial;
+		os1 << threaded;
+		EXPECT_EQ(os0.str(), os1.str());
+		EXPECT_LT(0, serial.size());
+	}
+	// the worker threads allocate from their own arenas, merged in the one of the caller
+	size_t nodes[2];
+	for (int threads = 1; threads <= 4; threads += 3) {
+		EvalArena arena;
+		Braket e = exp;
+		setThreads(threads);
+		e.evaluate(true);
+		setThreads(1);
+		nodes[threads > 1] = arena.nodes();
+	}
+	EXPECT_LT(0u, nodes[1]);
+	EXPECT_EQ(nodes[0], nodes[1]);
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, LazyProductsMatchEager) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket eager = psi_16p(bra, "i") * Bop("j") * GammaH(3) * psi_16p(ket, "k");
+	eager += psi_16p(bra, "i") * Bop("j") * GammaH(1) * psi_16p(ket, "k");
+	setLazyProducts();
+	Braket lazy = psi_16p(bra, "i") * Bop("j") * GammaH(3) * psi_16p(ket, "k");
+	lazy += psi_16p(bra, "i") * Bop("j") * GammaH(1) * psi_16p(ket, "k");
+	unsetLazyProducts();
+	ostringstream os0, os1;
+	os0 << eager;
+	os1 << lazy;
+	EXPECT_EQ(os0.str(), os1.str());
+	eager.evaluate(true);
+	lazy.evaluate(true);
+	EXPECT_EQ(eager.size(), lazy.size());
+	CleanGlobalDecl();
+}
+
+/*! \brief Prints "x op= x" computed with and without deferred products */
+static void selfOperation(const Braket& x, char op, string& eager, string& lazy) {
+	for (int mode = 0; mode < 2; mode++) {
+		if (mode) setLazyProducts();
+		Braket y = x;
+		if (op == '+') y += y;
+		if (op == '-') y -= y;
+		if (op == '*') y *= y;
+		if (mode) unsetLazyProducts();
+		ostringstream os;
+		os << y << y.size();
+		(mode ? lazy : eager) = os.str();
+	}
+}
+
+TEST(SospinBraketTest, LazySelfOperationsMatchEager) {
+	setDim(6);
+	setVerbosity(SILENT);
+	Braket x = Bop("j");
+	string eager, lazy;
+	selfOperation(x, '+', eager, lazy);
+	EXPECT_EQ(eager, lazy);
+	selfOperation(x, '-', eager, lazy);
+	EXPECT_EQ(eager, lazy);
+	selfOperation(x, '*', eager, lazy);
+	EXPECT_EQ(eager, lazy);
+	EXPECT_NE("0", eager);
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, LazyOperandsAreCopiedOnWrite) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket a = psi_16p(bra, "i"), b = Bop("j") * GammaH(3) * psi_16p(ket, "k");
+	ostringstream os0;
+	os0 << a;
+	setLazyProducts();
+	Braket c = a * b;
+	Braket d = a * b;
+	unsetLazyProducts();
+	// the operands share their terms with the deferred products, a change of one does not reach the others
+	a.Get(0).GetCoef() *= Coefficient("7");
+	ostringstream os1, os2, os3;
+	os1 << c;
+	os2 << d;
+	os3 << a;
+	EXPECT_EQ(os1.str(), os2.str());
+	EXPECT_NE(os0.str(), os3.str());
+	EXPECT_EQ(psi_16p(bra, "i").size(), a.size());
+	EXPECT_LT(0, c.size());
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, CollectMergesLikeTerms) {
+	setDim(10);
+	setVerbosity(SILENT);
+	int i = newIdx("i"), j = newIdx("j"), k = newIdx("k"), l = newIdx("l");
+	DList d0, d1, d2, d3;
+	d0 << elemType::make_elem(2, i, j) << elemType::make_elem(2, k, l);
+	d1 << elemType::make_elem(2, l, k) << elemType::make_elem(2, j, i);
+	d2 << elemType::make_elem(2, i, j) << elemType::make_elem(2, k, l);
+	d2.set_sign(-1);
+	d3 << elemType::make_elem(2, i, k) << elemType::make_elem(2, j, l);
+	Braket exp(0, "a", d0, none);
+	exp += Braket(0, "b", d1, none);
+	exp += Braket(0, "c", d2, none);
+	exp += Braket(0, "x", d3, none);
+	exp.collect();
+	ASSERT_EQ(2, exp.size());
+	EXPECT_EQ("((a)+(b)-(c))", exp.Get(0).GetConst());
+	EXPECT_EQ("x", exp.Get(1).GetConst());
+	// a term whose DLists cancel is removed
+	DList d4 = d0;
+	d4.set_sign(-1);
+	BraketOneTerm zero(0, "z", d0);
+	zero.GetTerm().push_back(d4);
+	EXPECT_TRUE(zero.canonicalize());
+	CleanGlobalDecl();
+}
+
+/*! \brief Integer value of a constant part: a number, or a sum "((n1)+(n2)-...)" written by Braket::collect() */
+static long long constValue(BraketOneTerm& term) {
+	long long n, d;
+	if (term.GetCoef().empty()) return 1;
+	if (term.GetCoef().rational(n, d)) {
+		EXPECT_EQ(1, d);
+		return n;
+	}
+	string c = term.GetConst();
+	EXPECT_EQ("((", c.substr(0, 2));
+	long long sum = 0;
+	int sign = 1;
+	for (size_t k = 1; k + 1 < c.size(); k++) {
+		if (c[k] == '+') sign = 1;
+		if (c[k] == '-') sign = -1;
+		if (c[k] != '(') continue;
+		size_t close = c.find(')', k);
+		sum += sign * atoll(c.substr(k + 1, close - k - 1).c_str());
+		k = close;
+	}
+	return sum;
+}
+
+/*! \brief Sum of value * sign of each product of deltas of an expression evaluated to deltas, zero sums removed */
+static map<string, long long> deltaValues(Braket& exp) {
+	map<string, long long> values;
+	for (int i = 0; i < exp.size(); i++) {
+		BraketOneTerm& term = exp.Get(i);
+		long long value = constValue(term);
+		for (list<DList>::iterator it = term.GetTerm().begin(); it != term.GetTerm().end(); ++it) {
+			vector<string> deltas;
+			for (unsigned int k = 0; k < (*it).size(); k++) {
+				elemType e = (*it).at(k);
+				EXPECT_EQ(2u, e.getType());
+				string a = getIdx(e.getIdx1()), b = getIdx(e.getIdx2());
+				if (b < a) swap(a, b);
+				deltas.push_back("d(" + a + "," + b + ")");
+			}
+			sort(deltas.begin(), deltas.end());
+			string key;
+			for (size_t k = 0; k < deltas.size(); k++) key += deltas[k];
+			values[key] += value * (*it).getSign();
+		}
+	}
+	for (map<string, long long>::iterator it = values.begin(); it != values.end();) {
+		if (it->second == 0)
+			values.erase(it++);
+		else
+			++it;
+	}
+	return values;
+}
+
+TEST(SospinBraketTest, CollectKeepsEvaluatedResult) {
+	setDim(10);
+	setVerbosity(SILENT);
+	// numeric constant parts, the like terms of the result are merged in sums of numbers
+	Braket exp = Braket(0, "2", bb("i") * bb("j"), bra) * Braket(0, "3", bbt("k") * bbt("l"), ket);
+	exp += Braket(0, "5", bb("j") * bb("i"), bra) * Braket(0, "", bbt("k") * bbt("l"), ket);
+	exp += Braket(0, "7", bb("i") * bb("j"), bra) * Braket(0, "", bbt("l") * bbt("k"), ket);
+	exp += Braket(0, "11", bb("i") * bb("k"), bra) * Braket(0, "", bbt("j") * bbt("l"), ket);
+	Braket collected = exp;
+	exp.evaluate(true);
+	setCollectTerms();
+	collected.evaluate(true);
+	unsetCollectTerms();
+	EXPECT_LT(collected.size(), exp.size());
+	map<string, long long> a = deltaValues(exp);
+	map<string, long long> b = deltaValues(collected);
+	EXPECT_FALSE(a.empty());
+	EXPECT_TRUE(a == b);
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, WriteFormMatchesStream) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket exp = psi_16p(bra, "i") * Bop("j") * GammaH(3) * psi_16p(ket, "k");
+	exp.evaluate(true);
+	ostringstream os0, os1, os2;
+	exp.setON();
+	os0 << exp;
+	exp.setOFF();
+	exp.writeForm(os1);
+	setThreads(4);
+	exp.writeForm(os2);
+	setThreads(1);
+	EXPECT_EQ(os0.str(), os1.str());
+	EXPECT_EQ(os0.str(), os2.str());
+	EXPECT_NE(string::npos, os1.str().find("Local R1 = "));
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, SO10TemplatesMatchColdBuild) {
+	setDim(10);
+	setVerbosity(SILENT);
+	clearSO10Templates();
+	ostringstream cold, coldGamma;
+	cold << psi_16p(bra, "i");
+	coldGamma << GammaH(3);
+	string coldFunctions = form.getFunction();
+	CleanGlobalDecl();
+	// the index table changed, the warm calls relabel the templates
+	newIdx("zz");
+	ostringstream warm, warmGamma;
+	warm << psi_16p(bra, "i");
+	warmGamma << GammaH(3);
+	EXPECT_EQ(cold.str(), warm.str());
+	EXPECT_EQ(coldGamma.str(), warmGamma.str());
+	EXPECT_EQ(coldFunctions, form.getFunction());
+	// another index head is relabelled from the "i" template
+	ostringstream relabelled, built;
+	relabelled << psi_16p(bra, "m");
+	clearSO10Templates();
+	built << psi_16p(bra, "m");
+	EXPECT_EQ(built.str(), relabelled.str());
+	EXPECT_NE(string::npos, built.str().find("m5"));
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, SaveLoadRoundTrip) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket exp = psi_16p(bra, "i") * Bop("j") * GammaH(3) * psi_16p(ket, "k");
+	exp.evaluate();
+	ostringstream saved;
+	saved << exp;
+	string functions = form.getFunction();
+	ASSERT_TRUE(exp.save("braket_checkpoint.bin"));
+	Braket same;
+	ASSERT_TRUE(same.load("braket_checkpoint.bin"));
+	ostringstream loaded;
+	loaded << same;
+	EXPECT_EQ(saved.str(), loaded.str());
+	// another index table, the indices are renumbered
+	CleanGlobalDecl();
+	newIdx("zz");
+	Braket renumbered;
+	ASSERT_TRUE(renumbered.load("braket_checkpoint.bin"));
+	ostringstream reloaded;
+	reloaded << renumbered;
+	EXPECT_EQ(saved.str(), reloaded.str());
+	EXPECT_EQ(functions, form.getFunction());
+	EXPECT_FALSE(renumbered.load("no_such_checkpoint.bin"));
+	remove("braket_checkpoint.bin");
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, SpilledEvaluationMatchesInMemory) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket exp = psi_16p(bra, "i") * Bop("j") * GammaH(3) * psi_16p(ket, "k");
+	Braket spilled = exp;
+	exp.evaluate();
+	ostringstream inMemory, inMemoryForm;
+	inMemory << exp;
+	exp.writeForm(inMemoryForm);
+	// a budget of a few terms per chunk
+	setEvalMemoryBudget(4096);
+	spilled.evaluate();
+	unsetEvalMemoryBudget();
+	ostringstream streamed, streamedForm;
+	spilled.writeForm(streamedForm);
+	EXPECT_EQ(exp.size(), spilled.size());
+	EXPECT_EQ(inMemoryForm.str(), streamedForm.str());
+	streamed << spilled;
+	EXPECT_EQ(inMemory.str(), streamed.str());
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, CoefficientFoldsNumbers) {
+	Coefficient c("H20(r4, r5)");
+	EXPECT_EQ("H20(r4,r5)", c.str());
+	c *= Coefficient("-2");
+	c *= Coefficient("3/4");
+	c *= Coefficient("sqrt(2)");
+	EXPECT_EQ("-3/2*H20(r4,r5)*sqrt(2)", c.str());
+	c.negate();
+	EXPECT_EQ("3/2*H20(r4,r5)*sqrt(2)", c.str());
+	EXPECT_EQ("", Coefficient().str());
+	EXPECT_EQ("x", (Coefficient("1") * Coefficient("x")).str());
+	Coefficient m;
+	m.negate();
+	EXPECT_EQ("-1", m.str());
+	// prefactors too large to fold are kept as factors
+	Coefficient big("999999999999999999");
+	big *= Coefficient("999999999999999999");
+	EXPECT_EQ("999999999999999999*999999999999999999", big.str());
+	EXPECT_EQ("2/3", (Coefficient("4/9") * Coefficient("3/2")).str());
+	vector<Coefficient> addends = {Coefficient("a"), Coefficient(), Coefficient("2*b")};
+	EXPECT_EQ("((a)+(1)-(2*b))", Coefficient::sum(addends, {1, 1, -1}).str());
+	// the product of terms multiplies their coefficients
+	BraketOneTerm t1(0, "2", DList()), t2(0, "x", DList());
+	EXPECT_EQ("2*x", (t1 * t2).GetConst());
+}
+
+TEST(SospinBraketTest, PhaseStatsCountTerms) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket exp = Bop("j") * psi_16p(ket, "k");
+	resetStats();
+	size_t before = exp.size();
+	exp.simplify();
+	size_t simplified = exp.size();
+	exp.evaluate();
+	EXPECT_LE(simplified, before);
+	vector<PhaseStats> phases = getPhaseStats();
+	ASSERT_EQ((size_t)PHASE_COUNT, phases.size());
+	EXPECT_EQ("simplify", phases[PHASE_SIMPLIFY].name);
+#ifdef SOSPIN_STATS
+	// evaluate() simplifies again
+	EXPECT_EQ(2u, phases[PHASE_SIMPLIFY].calls);
+	EXPECT_EQ(before + simplified, phases[PHASE_SIMPLIFY].termsIn);
+	EXPECT_EQ(2 * simplified, phases[PHASE_SIMPLIFY].termsOut);
+	EXPECT_EQ(simplified, phases[PHASE_EVAL_DELTAS].calls);
+	EXPECT_GE(phases[PHASE_SIMPLIFY].wall, 0.0);
+	EXPECT_NE(string::npos, stats().find("\"enabled\": true"));
+#else
+	EXPECT_EQ(0u, phases[PHASE_SIMPLIFY].calls);
+#endif
+	EXPECT_NE(string::npos, stats().find("\"name\": \"EvaluateToDeltas\""));
+	resetStats();
+	EXPECT_EQ(0u, getPhaseStats()[PHASE_SIMPLIFY].calls);
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, ProgressCallbackSink) {
+	setDim(10);
+	Braket exp = Bop("j") * psi_16p(ket, "k");
+	mutex m;
+	vector<pair<size_t, size_t> > reports;
+	setProgressSink(make_shared<CallbackProgress>([&](const char* label, size_t step, size_t total) {
+		lock_guard<mutex> lock(m);
+		EXPECT_STREQ("Progress: ", label);
+		reports.push_back(make_pair(step, total));
+		// the sink is called without the reporter lock
+		EXPECT_TRUE(getProgressSink() != nullptr);
+		setProgressInterval(1);
+	}));
+	setProgressInterval(1);
+	setVerbosity(SUMMARIZE);
+	exp.evaluate();
+	setVerbosity(SILENT);
+	setProgressInterval(PROGRESS_INTERVAL);
+	setProgressSink(make_shared<TerminalProgress>());
+	// one report at least at the end of each loop, rearrange, checkindex, simplify and evaluate
+	ASSERT_FALSE(reports.empty());
+	for (size_t i = 0; i < reports.size(); i++) EXPECT_LE(reports[i].first, reports[i].second);
+	EXPECT_EQ(reports.back().first, reports.back().second);
+	// nothing is reported while SILENT
+	size_t n = reports.size();
+	{
+		Progress progress("Progress: ", 10);
+		progress.set(10);
+	}
+	EXPECT_EQ(n, reports.size());
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, BopMatchesExpandedProduct) {
+	setVerbosity(SILENT);
+	for (int n = 1; n <= 7; n++) {
+		setDim(2 * n);
+		// the product (b_1 - bt_1) ... (b_N - bt_N) as Bop() built it before
+		Braket product = Braket(bb("i1")) - Braket(bbt("i1"));
+		string eps = "e_(i1";
+		int factorial = 1;
+		for (int i = 2; i <= n; i++) {
+			string id = "i" + ToString<int>(i);
+			product = product * (Braket(bb(id)) - Braket(bbt(id)));
+			eps += "," + id;
+			factorial *= i;
+		}
+		string constpart = string(n % 2 == 0 ? "1/" : "i_/") + ToString<int>(factorial) + "*" + eps + ")";
+		product = (n % 4 == 0 || n % 4 == 3) ? product * constpart : -product * constpart;
+		ostringstream expected, actual;
+		expected << product;
+		actual << Bop();
+		EXPECT_EQ(expected.str(), actual.str()) << "SO(" << 2 * n << ")";
+		EXPECT_EQ(1 << n, Bop().size());
+		CleanGlobalDecl();
+	}
+}
+
+TEST(SospinBraketTest, ImplicitBopMatchesExpanded) {
+	setDim(10);
+	setVerbosity(SILENT);
+	Braket left = psi_16p(bra, "i"), right = GammaH(3) * psi_16p(ket, "k");
+	Braket expanded = left * Bop("j") * right;
+	setImplicitBop();
+	Braket b = Bop("j");
+	EXPECT_EQ(32, b.size());
+	Braket implicit = left * b * right;
+	unsetImplicitBop();
+	expanded.evaluate();
+	implicit.evaluate();
+	ostringstream expectedForm, implicitForm;
+	expanded.writeForm(expectedForm);
+	implicit.writeForm(implicitForm);
+	EXPECT_EQ(expectedForm.str(), implicitForm.str());
+	// B on the left of the product
+	ostringstream onLeft, implicitOnLeft;
+	onLeft << Bop("j") * right;
+	setImplicitBop();
+	implicitOnLeft << Bop("j") * right;
+	unsetImplicitBop();
+	EXPECT_EQ(onLeft.str(), implicitOnLeft.str());
+	// B times itself
+	ostringstream square, implicitSquare;
+	Braket x = Bop("j");
+	x *= x;
+	square << x;
+	setImplicitBop();
+	Braket y = Bop("j");
+	y *= y;
+	unsetImplicitBop();
+	implicitSquare << y;
+	EXPECT_EQ(square.str(), implicitSquare.str());
+	EXPECT_LT(0, y.size());
+	CleanGlobalDecl();
+}
+
+TEST(SospinBraketTest, ImplicitBopEvaluatesByBlocks) {
+	// SO(18), the 512 monomials of B are evaluated in two blocks of BOP_BLOCK_SIZE (256)
+	setDim(18);
+	setVerbosity(SILENT);
+	Braket left = Braket(0, "2", bb("1") * bb("2") * bb("3") * bb("4"), bra);
+	left += Braket(0, "3", bb("6") * bb("7") * bb("8") * bb("9"), bra);
+	Braket right = Braket(0, "", bbt("5") * bbt("6") * bbt("7") * bbt("8") * bbt("9"), ket);
+	right += Braket(0, "", bbt("1") * bbt("2") * bbt("3") * bbt("4") * bbt("5"), ket);
+	Braket expanded = left * BopIdnum() * right;
+	setImplicitBop();
+	Braket implicit = left * BopIdnum() * right;
+	unsetImplicitBop();
+	expanded.evaluate();
+	resetStats();
+	implicit.evaluate();
+#ifdef SOSPIN_STATS
+	// the product is not expanded and simplified whole before the evaluation
+	EXPECT_EQ(0u, getPhaseStats()[PHASE_SIMPLIFY].calls);
+#endif
+	// each left term gives one number, through a monomial of the second block for "2" and of the first block for "3":
+	// the blocks are evaluated in turn, the term order differs from the one of the expanded product
+	ASSERT_EQ(2, expanded.size());
+	ASSERT_EQ(2, implicit.size());
+	EXPECT_EQ(expanded.Get(0).GetConst(), implicit.Get(1).GetConst());
+	EXPECT_EQ(expanded.Get(1).GetConst(), implicit.Get(0).GetConst());
+	EXPECT_NE(implicit.Get(0).GetConst(), implicit.Get(1).GetConst());
+	CleanGlobalDecl();
+}
+
+/*! \brief Sum of the numbers of an expression evaluated to deltas on the Fock space */
+static long long sumNumbers(Braket& exp) {
+	long long sum = 0;
+	for (int i = 0; i < exp.size(); i++) {
+		long long n, d;
+		// the number times the identity
+		list<DList>& dl = exp.Get(i).GetTerm();
+		EXPECT_EQ(1u, dl.size());
+		EXPECT_EQ(1u, dl.front().size());
+		EXPECT_EQ(3u, dl.front().at(0).getType());
+		EXPECT_EQ(1, dl.front().getSign());
+		EXPECT_TRUE(exp.Get(i).GetCoef().rational(n, d));
+		EXPECT_EQ(1, d);
+		sum += n;
+	}
+	return sum;
+}
+
+/*! \brief Sum of the numeric deltas of an expression evaluated to deltas, with numeric constant parts */
+static long long sumDeltas(Braket& exp) {
+	long long sum = 0;
+	for (int i = 0; i < exp.size(); i++) {
+		BraketOneTerm& term = exp.Get(i);
+		long long n = 1, d = 1;
+		if (!term.GetCoef().empty()) {
+			EXPECT_TRUE(term.GetCoef().rational(n, d));
+		}
+		for (list<DList>::iterator it = term.GetTerm().begin(); it != term.GetTerm().end(); ++it) {
+			int value = (*it).getSign();
+			for (unsigned int k = 0; k < (*it).size(); k++) {
+				elemType e = (*it).at(k);
+				EXPECT_EQ(2u, e.getType());
+				if (getIdxValue(e.getIdx1()) != getIdxValue(e.getIdx2())) value = 0;
+			}
+			sum += n * value;
+		}
+	}
+	return sum;
+}
+
+TEST(SospinBraketTest, FockMatchesDeltas) {
+	// SO(8): BopIdnum() has no i_
+	setDim(8);
+	setVerbosity(SILENT);
+	Braket exp = Braket(0, "", bb(1) * bb(2), bra) * BopIdnum() * Braket(0, "", bbt(3) * bbt(4), ket);
+	exp += Braket(0, "3", bb(1) * bb(2) * bb(3) * bb(4), bra) * BopIdnum() * Braket(0, "", identity, ket);
+	exp += Braket(0, "2", bb(4) * bb(1), bra) * BopIdnum() * Braket(0, "", bbt(2) * bbt(3), ket);
+	exp += Braket(0, "", bb(1) * bb(2), bra) * BopIdnum() * Braket(0, "", bbt(1) * bbt(2), ket);
+	Braket fock = exp;
+	fock.evaluate();
+	unsetFockEvaluation();
+	exp.evaluate();
+	setFockEvaluation();
+	EXPECT_LT(0, fock.size());
+	EXPECT_NE(0, sumNumbers(fock));
+	EXPECT_EQ(sumDeltas(exp), sumNumbers(fock));
+	// the numbers are kept by simplify() and by sums, as the results of the delta evaluation
+	int terms = fock.size();
+	fock.simplify();
+	EXPECT_EQ(terms, fock.size());
+	Braket twice = fock + fock;
+	EXPECT_EQ(2 * terms, twice.size());
+	EXPECT_EQ(2 * sumNumbers(fock), sumNumbers(twice));
+	fock += fock;
+	EXPECT_EQ(2 * terms, fock.size());
+	// <0| b(1) b(2) bt(2) bt(1) |0> = 1, <0| b(1) bt(2) |0> = 0
+	FockState s = FockState::vacuum();
+	EXPECT_TRUE(s.apply(bb(1) * bb(2) * bbt(2) * bbt(1)));
+	EXPECT_EQ(1, s.amplitude(0));
+	s = FockState::vacuum();
+	s.apply(bb(1) * bbt(2));
+	EXPECT_TRUE(s.empty());
+	s = FockState::vacuum();
+	EXPECT_FALSE(s.apply(bb("a") * bbt(1)));
+	EXPECT_EQ(1, s.amplitude(0));
+	// indices that are not positive numbers are symbolic, the brakets with them are evaluated to deltas
+	EXPECT_FALSE(s.apply(bb("-1") * bbt("-1")));
+	EXPECT_FALSE(s.apply(bb("0") * bbt("0")));
+	EXPECT_FALSE(s.apply(bb("1a") * bbt("1a")));
+	EXPECT_EQ(1, s.amplitude(0));
+	Braket negative = Braket(0, "", bb("-1"), bra) * Braket(0, "", bbt("-1"), ket);
+	negative.evaluate();
+	ASSERT_EQ(1, negative.size());
+	ASSERT_EQ(1u, negative.Get(0).GetTerm().size());
+	EXPECT_EQ(2u, negative.Get(0).GetTerm().front().at(0).getType());
+	CleanGlobalDecl();
+}
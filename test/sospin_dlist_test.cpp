@@ -29,8 +29,10 @@
 #include <iostream>
 #include <sstream>
 
+#include <sospin/arena.h>
 #include <sospin/dlist.h>
 #include <sospin/index.h>
+#include <sospin/son.h>
 
 using namespace sospin;
 using namespace std;
@@ -46,3 +48,112 @@ TEST(SospinDListTest, CreationOperators) {
 	EXPECT_EQ(4, list.numBs());
 	EXPECT_THAT(os.str(), ContainsRegex("\\+ b\\([0-9]\\) (\\* b\\([0-9]\\))* \\* b\\([0-9]\\)")) << "Not The expected expression: " + oss;
 }
+
+TEST(SospinDListTest, SpillToHeapStorage) {
+	DList list;
+	for (int i = 1; i <= 3 * DLIST_INLINE_SIZE; i++) list << elemType::make_elem(i % 2, newIdx(i));
+	DList copied = list;
+	EXPECT_EQ(3u * DLIST_INLINE_SIZE, copied.size());
+	EXPECT_TRUE(copied == list);
+	EXPECT_EQ(3 * DLIST_INLINE_SIZE / 2, copied.numBs());
+	EXPECT_TRUE(copied.isActualLast());
+}
+
+TEST(SospinDListTest, ContractDeltas) {
+	// b(1) * bt(2) * bt(3) -> d(1,2) * bt(3) - bt(2) * b(1) * bt(3)
+	DList list = DList(0, newIdx(1)) * DList(1, newIdx(2)) * DList(1, newIdx(3));
+	DList swapped = contract_deltas(list, false);
+	ostringstream os0, os1;
+	os0 << list;
+	os1 << swapped;
+	EXPECT_EQ("\t + d(1,2)@ * bt(3) ", os0.str());
+	EXPECT_EQ("\t - bt(2) * b(1)@ * bt(3) ", os1.str());
+}
+
+TEST(SospinDListTest, ArenaOutlivesScope) {
+	DList list;
+	{
+		EvalArena arena(4096);
+		EXPECT_EQ(&arena, EvalArena::current());
+		for (int i = 1; i <= 3 * DLIST_INLINE_SIZE; i++) list << elemType::make_elem(1, newIdx(i));
+		DList tmp = list;
+		EXPECT_LT(0u, arena.nodes());
+		EXPECT_LT(0u, arena.bytesInUse());
+	}
+	EXPECT_TRUE(EvalArena::current() == 0);
+	// the buffer of "list" is still valid after the arena is gone
+	DList copied = list;
+	EXPECT_TRUE(copied == list);
+	EXPECT_EQ(0, copied.numBs());
+	EXPECT_EQ(3u * DLIST_INLINE_SIZE, copied.size());
+}
+
+TEST(SospinDListTest, ElemTypeFields) {
+	unsigned int top = elemType::maxIndices() - 1;
+	elemType elem = elemType::make_elem(2, top, 5);
+	elem.setSign(true);
+	EXPECT_EQ(2u, elem.getType());
+	EXPECT_TRUE(elem.getSign());
+	EXPECT_EQ(top, elem.getIdx1());
+	EXPECT_EQ(5u, elem.getIdx2());
+	elem.setIdx2(top);
+	elem.setType(1);
+	EXPECT_EQ(1u, elem.getType());
+	EXPECT_EQ(top, elem.getIdx1());
+	EXPECT_EQ(top, elem.getIdx2());
+}
+
+TEST(SospinDListTest, IndexInterning) {
+	clearIdx();
+	vector<int> ids;
+	for (int i = 0; i < 1000; i++) ids.push_back(newIdx("x" + ToString<int>(i)));
+	for (int i = 0; i < 1000; i++) {
+		EXPECT_EQ(ids[i], newIdx("x" + ToString<int>(i)));
+		EXPECT_EQ("x" + ToString<int>(i), getIdx(ids[i]));
+	}
+	EXPECT_EQ(newIdx("x7"), newIdx(string("x7")));
+	// the table is emptied with the indices
+	clearIdx();
+	EXPECT_EQ(0, newIdx(7));
+	EXPECT_EQ(0, newIdx("7"));
+	EXPECT_EQ(1, newIdx("x7"));
+	EXPECT_EQ(2, Idx_size());
+	clearIdx();
+}
+
+TEST(SospinDListTest, CheckDeltaIndex) {
+	setDim(10);
+	elemType d12 = elemType::make_elem(2, newIdx(1), newIdx(2));
+	elemType d11 = elemType::make_elem(2, newIdx(1), newIdx(1));
+	elemType di2 = elemType::make_elem(2, newIdx("i"), newIdx(2));
+	elemType d6i = elemType::make_elem(2, newIdx(6), newIdx("i"));
+	DList L;
+	L << d12;
+	EXPECT_FALSE(L.checkDeltaIndex());
+	L.clear();
+	L << d11;
+	L << di2;
+	EXPECT_TRUE(L.checkDeltaIndex());
+	L << d6i;
+	EXPECT_FALSE(L.checkDeltaIndex());
+}
+
+TEST(SospinDListTest, MonomialInfo) {
+	setDim(10);
+	DList L;
+	L << elemType::make_elem(2, newIdx("i"), newIdx(2));
+	L << elemType::make_elem(1, newIdx("j"));
+	L << elemType::make_elem(0, newIdx("k"));
+	L << elemType::make_elem(0, newIdx("l"));
+	MonomialInfo info = L.info();
+	EXPECT_EQ(info.nb, 2);
+	EXPECT_EQ(info.nbt, 1);
+	EXPECT_EQ(info.first, 1);
+	EXPECT_EQ(info.last, 0);
+	EXPECT_TRUE(info.deltas);
+	L << elemType::make_elem(2, newIdx(1), newIdx(3));
+	EXPECT_FALSE(L.info().deltas);
+	DList E;
+	EXPECT_EQ(E.info().first, -1);
+	EXPECT_EQ(E.info().last, -1);
+}
@@ -0,0 +1,179 @@
+// ----------------------------------------------------------------------------
+// SOSpin Library
+// Copyright (C) 2026 SOSpin Project
+//
+//   Authors:
+//
+//     Nuno Cardoso (nuno.cardoso@tecnico.ulisboa.pt)
+//     David Emmanuel-Costa (david.costa@tecnico.ulisboa.pt)
+//     Nuno Gonçalves (nunogon@deec.uc.pt)
+//     Catarina Simoes (csimoes@ulg.ac.be)
+//
+// ----------------------------------------------------------------------------
+// This file is part of SOSpin Library.
+//
+// SOSpin Library is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or any
+// later version.
+//
+// SOSpin Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with SOSpin Library.  If not, see <http://www.gnu.org/licenses/>.
+// ----------------------------------------------------------------------------
+
+
+#include <gtest/gtest.h>
+
+#include <sospin/son.h>
+
+using namespace sospin;
+using namespace std;
+
+TEST(SospinFormTest, SessionIsReused) {
+	setDim(10);
+	setVerbosity(SILENT);
+	form.setFilename("form_session_test");
+	startFormSession(FORM_STUB);
+	ASSERT_TRUE(formSessionRunning());
+	DList d0;
+	d0 << elemType::make_elem(2, newIdx("i"), newIdx("j"));
+	for (int call = 1; call <= 2; call++) {
+		Braket exp(0, "a", d0, none);
+		exp += Braket(0, "b", d0, none);
+		CallForm(exp, false, false);
+		ASSERT_EQ(2, exp.size());
+		EXPECT_EQ(to_string(call) + "*y", exp.Get(0).GetConst());
+		EXPECT_EQ("+2*x", exp.Get(1).GetConst());
+	}
+	stopFormSession();
+	EXPECT_FALSE(formSessionRunning());
+	form.clear();
+	CleanGlobalDecl();
+}
+
+TEST(SospinFormTest, ParseFormOutputSplitsTopLevelTerms) {
+	setDim(10);
+	setVerbosity(SILENT);
+	string text = "   R =\n      - 2*d_(N1_?,N2_?)*(a - b)\n       + x^-1*sqrt(1 + y) + N12_?;\n\n  0.01 sec\n";
+	FormOutput out = ParseFormOutput(text.data(), text.data() + text.size(), "j");
+	ASSERT_EQ(3u, out.terms.size());
+	EXPECT_EQ("-2*d_(j1,j2)*(a-b)", out.terms[0]);
+	EXPECT_EQ("+x^-1*sqrt(1+y)", out.terms[1]);
+	EXPECT_EQ("+j12", out.terms[2]);
+	EXPECT_EQ(string::npos, out.text.find("N1_?"));
+	EXPECT_EQ("R =", out.text.substr(out.result, 3));
+	EXPECT_EQ(';', out.text[out.resultEnd - 1]);
+	string none = "no result";
+	EXPECT_EQ(string::npos, ParseFormOutput(none.data(), none.data() + none.size(), "j").result);
+	CleanGlobalDecl();
+}
+
+TEST(SospinFormTest, ShardsSumPartialResults) {
+	setDim(10);
+	setVerbosity(SILENT);
+	form.setFilename("form_shards_test");
+	form.rpath() = FORM_STUB;
+	// the stand-in FORM reads one line per term, the terms are constants
+	Braket exp;
+	exp.expfromForm({"a", "b", "-c", "d", "e"});
+	Braket single = exp;
+	CallForm(single, false, false);
+	setFormShards(2);
+	CallForm(exp, false, false);
+	unsetFormShards();
+	ASSERT_EQ(5, exp.size());
+	ASSERT_EQ(single.size(), exp.size());
+	for (int i = 0; i < exp.size(); i++) EXPECT_EQ(single.Get(i).GetConst(), exp.Get(i).GetConst());
+	EXPECT_EQ("-c", exp.Get(2).GetConst());
+	EXPECT_TRUE(ifstream("form_shards_test_1_in.frm").good());
+	EXPECT_TRUE(ifstream("form_shards_test_2_in.frm").good());
+	form.clear();
+	CleanGlobalDecl();
+}
+
+TEST(SospinFormTest, CacheSkipsFormOnHit) {
+	setDim(10);
+	setVerbosity(SILENT);
+	form.setFilename("form_cache_test");
+	form.rpath() = FORM_STUB;
+	string dir = "form_cache_test_dir";
+	// empty the cache left by a previous run
+	setFormCache(dir, 0);
+	setFormCache(dir);
+	Braket first;
+	first.expfromForm({"a", "-b"});
+	Braket second = first;
+	CallForm(first, false, false);
+	EXPECT_EQ(0u, getFormCache().hits());
+	// the key is hashed while the input file is written, from the program between the header and ".end"
+	ifstream in("form_cache_test_in.frm");
+	string line, program;
+	for (int l = 0; getline(in, line); l++)
+		if (l >= 9 && line != ".end") program += line + "\n";
+	EXPECT_TRUE(ifstream((dir + "/" + FormCache::key(program) + ".frc").c_str()).good());
+	// a hit must not run FORM
+	form.rpath() = "/nonexistent/form";
+	CallForm(second, false, false);
+	EXPECT_EQ(1u, getFormCache().hits());
+	ASSERT_EQ(first.size(), second.size());
+	for (int i = 0; i < first.size(); i++) EXPECT_EQ(first.Get(i).GetConst(), second.Get(i).GetConst());
+	// every result is evicted with a limit of one byte
+	form.rpath() = FORM_STUB;
+	setFormCache(dir, 1);
+	Braket third;
+	third.expfromForm({"a", "-b"});
+	CallForm(third, false, false);
+	third.clear();
+	third.expfromForm({"a", "-b"});
+	CallForm(third, false, false);
+	EXPECT_EQ(0u, getFormCache().hits());
+	EXPECT_EQ(2u, getFormCache().misses());
+	unsetFormCache();
+	form.clear();
+	CleanGlobalDecl();
+}
+
+TEST(SospinFormTest, NativeLeviCivitaSkipsForm) {
+	setDim(10);
+	setVerbosity(SILENT);
+	form.setFilename("form_native_test");
+	form.rpath() = "/nonexistent/form";
+	setNativeLeviCivita();
+	// <0| b1 b2 bt1 bt2 |0> and <0| b1 b2 bt2 bt1 |0>
+	DList d0, d1;
+	d0 << elemType::make_elem(0, newIdx("1")) << elemType::make_elem(0, newIdx("2"));
+	d1 = d0;
+	d0 << elemType::make_elem(1, newIdx("1")) << elemType::make_elem(1, newIdx("2"));
+	d1 << elemType::make_elem(1, newIdx("2")) << elemType::make_elem(1, newIdx("1"));
+	Braket exp(0, "", d0, braket);
+	exp += Braket(0, "3", d1, braket);
+	exp.evaluate(false);
+	ASSERT_EQ(2, exp.size());
+	EXPECT_EQ("-1", exp.Get(0).GetConst());
+	EXPECT_EQ("3", exp.Get(1).GetConst());
+	// FORM is not found, the numbers are summed without it
+	CallForm(exp, false, false);
+	ASSERT_EQ(1, exp.size());
+	EXPECT_EQ("2", exp.Get(0).GetConst());
+	// free indices give the determinant of the deltas
+	DList d;
+	d << elemType::make_elem(0, newIdx("i1")) << elemType::make_elem(0, newIdx("i2"));
+	d << elemType::make_elem(1, newIdx("j1")) << elemType::make_elem(1, newIdx("j2"));
+	Braket sym(0, "", d, braket);
+	sym.evaluate(false);
+	unsetNativeLeviCivita();
+	EXPECT_EQ("(\n+d_(i1,j2)*d_(i2,j1)\n-d_(i1,j1)*d_(i2,j2)\n)", sym.Get(0).GetConst());
+	// otherwise the numbers are left to FORM, the stub writes them back without summing them
+	form.rpath() = FORM_STUB;
+	Braket numbers;
+	numbers.expfromForm({"1", "2"});
+	CallForm(numbers, false, false);
+	EXPECT_EQ(2, numbers.size());
+	form.clear();
+	CleanGlobalDecl();
+}